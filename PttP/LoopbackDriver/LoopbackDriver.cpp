@@ -0,0 +1,743 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LoopbackDriver.cpp - Sends a file between two I/O threads over a loopback link, with no window.
+--
+-- PROGRAM: LoopbackDriver
+--
+-- FUNCTIONS:
+-- CompletionSink()
+-- void Start(const qint64 size, const qint64 offset)
+-- void Write(const ByteView& data)
+-- void Finish()
+-- LineNoise(const double byteErrorRate, const int lengthErrorInterval, const unsigned int seed)
+-- void Damage(const int side, char* data, const int length)
+-- bool sameContents(const QString& first, const QString& second)
+-- bool writeTestFile(const QString& name, const qint64 size)
+-- TransferResult transfer(QApplication& app, const QString& input, const QString& output, const QString& port,
+--		const IOThread::ArqMode arqMode, const int maxDataLength, LineNoise* noise, const int timeout)
+-- int runTests(QApplication& app)
+-- int main(int argc, char* argv[])
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 17, 2026 - Runs a set of transfers over clean and damaged links when no file is given.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Usage: LoopbackDriver [file to send] [file to save it as]
+--
+-- Two I/O threads open the two ends of one LoopbackTransport and run the whole protocol against each other, one
+-- sending the file and the other saving it through a FileSink, the same way the program does over a serial port. When
+-- the transfer is done the two files are compared and the time it took is printed. The exit code is 0 if the file
+-- arrived intact and 1 if it did not or the transfer did not finish within TRANSFER_TIMEOUT.
+--
+-- Nothing but a copy into memory sits between the two threads, so this shows how fast the program itself can go and
+-- can be run where there is no serial port and no display.
+--
+-- With no file, a test file is made and sent once for each entry in TEST_CASES, with both kinds of resending, over a
+-- clean link and over links that flip bits at random or in the length of data frames. Each one must arrive intact,
+-- the damaged ones must have been answered with NAKs, and on the noisiest link the sender must have made its frames
+-- smaller. This is what make check runs.
+----------------------------------------------------------------------------------------------------------------------*/
+#include <atomic>
+#include <cstdio>
+#include <random>
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QTimer>
+
+#include "FileSink.h"
+#include "IOThread.h"
+#include "LoopbackTransport.h"
+#include "ReceiveSink.h"
+
+#define LOOPBACK_PORT_NAME	LOOPBACK_PREFIX "driver"
+#define OUTPUT_FILE_NAME	"loopback-received.bin"
+#define TRANSFER_TIMEOUT	600000
+#define COMPARE_BLOCK_SIZE	(1 << 20)
+#define QUEUE_SAMPLE_TIME	1
+
+#define TEST_INPUT_NAME		"loopback-test-input.bin"
+#define TEST_OUTPUT_NAME	"loopback-test-output.bin"
+#define TEST_TIMEOUT		120000
+#define TEST_SEED			20261017
+
+using namespace std;
+
+class CompletionSink : public ReceiveSink
+{
+public:
+	CompletionSink();
+
+	void Start(const qint64 size, const qint64 offset) override;
+	void Write(const ByteView& data) override;
+	void Finish() override;
+
+private:
+	qint64 mSize;
+	qint64 mEnd;
+	bool mDone;
+};
+
+class LineNoise
+{
+public:
+	LineNoise(const double byteErrorRate, const int lengthErrorInterval, const unsigned int seed);
+
+	void Damage(const int side, char* data, const int length);
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetSmallestFrame()
+	--
+	-- DATE: Oct 17, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetSmallestFrame (void)
+	--
+	-- RETURNS: The fewest data bytes a data frame carried, or 0 if none was sent.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetSmallestFrame() const { return mDataFrames > 0 ? mSmallest : 0; }
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetLargestFrame()
+	--
+	-- DATE: Oct 17, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetLargestFrame (void)
+	--
+	-- RETURNS: The most data bytes a data frame carried, or 0 if none was sent.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetLargestFrame() const { return mLargest; }
+
+private:
+	struct Direction
+	{
+		int position;
+		int size;
+		int dataLength;
+		int damagedPosition;
+	};
+
+	Direction mDirections[2];
+	mt19937 mRandom;
+	double mByteErrorRate;
+	int mLengthErrorInterval;
+	int mDataFrames;
+	int mSmallest;
+	int mLargest;
+};
+
+struct TransferResult
+{
+	bool finished;
+	bool intact;
+	qint64 ms;
+	int naks;
+	int poolSize;
+	int poolHighWaterMark;
+	int poolInUse;
+	int writeQueuePeak;
+};
+
+struct TestCase
+{
+	const char* name;
+	IOThread::ArqMode arqMode;
+	int maxDataLength;
+	double byteErrorRate;
+	int lengthErrorInterval;
+	qint64 size;
+	bool expectNaks;
+	bool expectSmallerFrames;
+};
+
+static const TestCase TEST_CASES[] =
+{
+	{ "clean link, selective repeat", IOThread::SELECTIVE_REPEAT, DEFAULT_DATA_LENGTH, 0, 0, 1 << 20, false, false },
+	{ "clean link, go-back-N", IOThread::GO_BACK_N, DEFAULT_DATA_LENGTH, 0, 0, 1 << 20, false, false },
+	{ "bit flips, selective repeat", IOThread::SELECTIVE_REPEAT, DEFAULT_DATA_LENGTH, 2e-5, 0, 1 << 20, true, false },
+	{ "bit flips, go-back-N", IOThread::GO_BACK_N, DEFAULT_DATA_LENGTH, 2e-5, 0, 1 << 20, true, false },
+	{ "length flips, selective repeat", IOThread::SELECTIVE_REPEAT, DEFAULT_DATA_LENGTH, 0, 25, 1 << 20, true, false },
+	{ "length flips, go-back-N", IOThread::GO_BACK_N, DEFAULT_DATA_LENGTH, 0, 25, 1 << 20, true, false },
+	{ "noisy link, large frames", IOThread::SELECTIVE_REPEAT, 4096, 1e-3, 0, 1 << 18, true, true }
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CompletionSink
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Only tells the program to quit once.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		CompletionSink (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. A receive sink that keeps no data and only tells the program to quit once the whole file has arrived.
+----------------------------------------------------------------------------------------------------------------------*/
+CompletionSink::CompletionSink()
+	: mSize(-1)
+	, mEnd(0)
+	, mDone(false)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Start (const qint64 size, const qint64 offset)
+--						const qint64 size: The size of the whole file.
+--						const qint64 offset: The offset in the file of the first byte of this session.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void CompletionSink::Start(const qint64 size, const qint64 offset)
+{
+	mSize = size;
+	mEnd = offset;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Write (const ByteView& data)
+--						const ByteView& data: The data of the next frame in sequence.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void CompletionSink::Write(const ByteView& data)
+{
+	mEnd += data.size;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Finish
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Only tells the program to quit once.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Finish (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called on the receiving I/O thread at the end of every session. A transfer can take several sessions, so the
+-- program is only told to quit once the end of the file has been reached. A session that ends after that does not
+-- tell it again, since the quit would be left over for the next transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void CompletionSink::Finish()
+{
+	if (!mDone && mSize >= 0 && mEnd >= mSize)
+	{
+		mDone = true;
+		QMetaObject::invokeMethod(qApp, "quit", Qt::QueuedConnection);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LineNoise
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		LineNoise (const double byteErrorRate, const int lengthErrorInterval, const unsigned int seed)
+--						const double byteErrorRate: The chance that any one byte has a bit flipped.
+--						const int lengthErrorInterval: Every this many data frames have a bit of their length flipped,
+--							or 0 for none.
+--						const unsigned int seed: Where the random numbers start, so a run can be repeated.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Damages the bytes going through a loopback link the way a noisy serial line would.
+----------------------------------------------------------------------------------------------------------------------*/
+LineNoise::LineNoise(const double byteErrorRate, const int lengthErrorInterval, const unsigned int seed)
+	: mRandom(seed)
+	, mByteErrorRate(byteErrorRate)
+	, mLengthErrorInterval(lengthErrorInterval)
+	, mDataFrames(0)
+	, mSmallest(MAX_DATA_LENGTH)
+	, mLargest(0)
+{
+	mDirections[0] = mDirections[1] = { 0, 0, 0, -1 };
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Damage
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Damage (const int side, char* data, const int length)
+--						const int side: The end of the link that wrote the bytes.
+--						char* data: The bytes, which are changed where they are.
+--						const int length: The number of bytes.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Set as the tamper function of the link. Each side's bytes are followed frame by frame before any of them are
+-- changed, since the sender never writes a damaged frame, so the frames are always found however they were split
+-- into writes. This is how the length of every data frame is known, and how a bit of the length can be flipped in
+-- the frames that are picked for it.
+--
+-- On top of that, any byte of either side, control frames included, may have one of its bits flipped.
+----------------------------------------------------------------------------------------------------------------------*/
+void LineNoise::Damage(const int side, char* data, const int length)
+{
+	uniform_real_distribution<double> chance(0, 1);
+	Direction& direction = mDirections[side];
+
+	for (int i = 0; i < length; i++)
+	{
+		uint8_t byte = (uint8_t)data[i];
+
+		switch (direction.position)
+		{
+		case 0:
+			if (byte != SYN)
+			{
+				continue;
+			}
+			direction.size = 0;
+			direction.damagedPosition = -1;
+			break;
+		case 1:
+			switch (byte)
+			{
+			case ENQ:
+				direction.size = ENQ_FRAME_SIZE;
+				break;
+			case ACK:
+				direction.size = ACK_FRAME_SIZE;
+				break;
+			case NAK:
+				direction.size = NAK_FRAME_SIZE;
+				break;
+			case STX:
+				direction.size = DATA_HEADER_SIZE;
+				mDataFrames++;
+				if (mLengthErrorInterval > 0 && mDataFrames % mLengthErrorInterval == 0)
+				{
+					direction.damagedPosition = 3 + (int)(mRandom() % 2);
+				}
+				break;
+			default:
+				direction.size = CONTROL_FRAME_SIZE;
+				break;
+			}
+			break;
+		case 3:
+			if (direction.size == DATA_HEADER_SIZE)
+			{
+				direction.dataLength = byte << 8;
+			}
+			break;
+		case 4:
+			if (direction.size == DATA_HEADER_SIZE)
+			{
+				direction.dataLength |= byte;
+				direction.size += direction.dataLength + CRC_LENGTH;
+				mSmallest = qMin(mSmallest, direction.dataLength);
+				mLargest = qMax(mLargest, direction.dataLength);
+			}
+			break;
+		}
+
+		if (direction.position == direction.damagedPosition)
+		{
+			data[i] ^= 1 << (mRandom() % 8);
+		}
+		if (mByteErrorRate > 0 && chance(mRandom) < mByteErrorRate)
+		{
+			data[i] ^= 1 << (mRandom() % 8);
+		}
+
+		direction.position++;
+		if (direction.position == direction.size)
+		{
+			direction.position = 0;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: sameContents
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool sameContents (const QString& first, const QString& second)
+--						const QString& first: The path of one file.
+--						const QString& second: The path of the other file.
+--
+-- RETURNS:			True if both files could be read and hold the same bytes, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool sameContents(const QString& first, const QString& second)
+{
+	QFile a(first);
+	QFile b(second);
+	if (!a.open(QIODevice::ReadOnly) || !b.open(QIODevice::ReadOnly) || a.size() != b.size())
+	{
+		return false;
+	}
+
+	while (!a.atEnd())
+	{
+		if (a.read(COMPARE_BLOCK_SIZE) != b.read(COMPARE_BLOCK_SIZE))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: writeTestFile
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool writeTestFile (const QString& name, const qint64 size)
+--						const QString& name: The path of the file to make.
+--						const qint64 size: The number of bytes to put in it.
+--
+-- RETURNS:			True if the file was written, otherwise false.
+--
+-- NOTES:
+-- Fills the file with runs of NUL bytes, runs of the bytes the frames are made of and random bytes, so the data
+-- looks like frames to a receiver that has lost its place. It is the same every time.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool writeTestFile(const QString& name, const qint64 size)
+{
+	static const char framing[] = { SYN, STX, SYN, ACK, SYN, NAK, SYN, ENQ, SYN, EOT };
+	mt19937 random(TEST_SEED);
+	QByteArray data((int)size, '\0');
+
+	for (int i = 0; i < data.size(); i++)
+	{
+		switch ((i / 1000) % 4)
+		{
+		case 0:
+			break;
+		case 1:
+			data[i] = framing[i % sizeof(framing)];
+			break;
+		default:
+			data[i] = (char)random();
+			break;
+		}
+	}
+
+	QFile file(name);
+	return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: transfer
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		TransferResult transfer (QApplication& app, const QString& input, const QString& output,
+--							const QString& port, const IOThread::ArqMode arqMode, const int maxDataLength,
+--							LineNoise* noise, const int timeout)
+--						QApplication& app: The application whose event loop is run until the transfer ends.
+--						const QString& input: The path of the file to send.
+--						const QString& output: The path to save it as.
+--						const QString& port: The name of the loopback link to open.
+--						const IOThread::ArqMode arqMode: How the I/O threads resend lost frames.
+--						const int maxDataLength: The most data bytes the I/O threads may put in a frame.
+--						LineNoise* noise: What damages the bytes on the link, or nullptr for a clean link.
+--						const int timeout: How many ms the transfer may take.
+--
+-- RETURNS:			Whether the transfer finished in time and the file arrived intact, how long it took, how many
+--					NAKs the receiver sent, how the frame buffer pools were used and the most bytes the sender had
+--					waiting to be written.
+--
+-- NOTES:
+-- The file is only sent once the sending thread has opened it. The threads are stopped before the file sink, so the
+-- saved file is complete when it is compared.
+--
+-- The frame buffer pools of both threads are read before the threads are stopped. The most buffers either one had
+-- borrowed at once shows how close it came to running dry, and the buffers still borrowed at the end are the ones the
+-- sender's frame prefetcher built ahead.
+--
+-- The sender's write queue is looked at every QUEUE_SAMPLE_TIME ms while the transfer runs. The deepest it was seen
+-- shows whether the sender keeps the link busy without piling up frames in front of it.
+----------------------------------------------------------------------------------------------------------------------*/
+static TransferResult transfer(QApplication& app, const QString& input, const QString& output, const QString& port,
+	const IOThread::ArqMode arqMode, const int maxDataLength, LineNoise* noise, const int timeout)
+{
+	TransferResult result;
+	atomic<int> naks(0);
+	QElapsedTimer clock;
+
+	if (noise != nullptr)
+	{
+		LoopbackTransport::SetTamper(port, [noise](const int side, char* data, const int length) {
+			noise->Damage(side, data, length);
+		});
+	}
+
+	{
+		FileSink fileSink(output);
+		CompletionSink completion;
+		IOThread sender(nullptr, DEFAULT_WINDOW_SIZE, arqMode, maxDataLength);
+		IOThread receiver(nullptr, DEFAULT_WINDOW_SIZE, arqMode, maxDataLength);
+
+		receiver.AddReceiveSink(&fileSink);
+		receiver.AddReceiveSink(&completion);
+		QObject::connect(&receiver, &IOThread::UpdateLabel, &receiver, [&naks](const QString str) {
+			if (str == "NAK")
+			{
+				naks++;
+			}
+		}, Qt::DirectConnection);
+		QObject::connect(&sender, &IOThread::FileOpened, &sender, [&sender, &clock] {
+			clock.start();
+			sender.SendFile();
+		});
+
+		fileSink.start();
+		sender.start();
+		receiver.start();
+		receiver.OpenPort(port);
+		sender.OpenPort(port);
+		sender.GetFileManip()->Select(input);
+
+		QTimer timer;
+		timer.setSingleShot(true);
+		QObject::connect(&timer, &QTimer::timeout, &app, [] { QCoreApplication::exit(1); });
+		timer.start(timeout);
+
+		QTimer sampler;
+		result.writeQueuePeak = 0;
+		QObject::connect(&sampler, &QTimer::timeout, &app, [&sender, &result] {
+			result.writeQueuePeak = qMax(result.writeQueuePeak, sender.GetWriteQueueDepth());
+		});
+		sampler.start(QUEUE_SAMPLE_TIME);
+
+		result.finished = app.exec() == 0;
+		result.ms = qMax((qint64)1, clock.elapsed());
+		result.poolSize = sender.GetFramePool().GetSize();
+		result.poolHighWaterMark = qMax(sender.GetFramePool().GetHighWaterMark(),
+			receiver.GetFramePool().GetHighWaterMark());
+		result.poolInUse = sender.GetFramePool().GetInUse() + receiver.GetFramePool().GetInUse();
+	}
+
+	LoopbackTransport::SetTamper(port, LoopbackTamper());
+	result.intact = result.finished && sameContents(input, output);
+	result.naks = naks;
+	return result;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: runTests
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		int runTests (QApplication& app)
+--						QApplication& app: The application whose event loop runs the transfers.
+--
+-- RETURNS:			0 if every test passed, otherwise 1.
+--
+-- NOTES:
+-- Sends a test file once for each entry in TEST_CASES, each over a link of its own, and prints whether it passed.
+-- The files are made in the temporary directory and removed afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+static int runTests(QApplication& app)
+{
+	QString input = QDir::temp().filePath(TEST_INPUT_NAME);
+	QString output = QDir::temp().filePath(TEST_OUTPUT_NAME);
+	int failed = 0;
+	int count = (int)(sizeof(TEST_CASES) / sizeof(TEST_CASES[0]));
+
+	for (int i = 0; i < count; i++)
+	{
+		const TestCase& test = TEST_CASES[i];
+		if (!writeTestFile(input, test.size))
+		{
+			fprintf(stderr, "could not write %s\n", qPrintable(input));
+			return 1;
+		}
+
+		LineNoise noise(test.byteErrorRate, test.lengthErrorInterval, TEST_SEED + i);
+		TransferResult result = transfer(app, input, output, QString(LOOPBACK_PREFIX "test-%1").arg(i),
+			test.arqMode, test.maxDataLength, &noise, TEST_TIMEOUT);
+
+		const char* problem = nullptr;
+		if (!result.finished)
+		{
+			problem = "did not finish in time";
+		}
+		else if (!result.intact)
+		{
+			problem = "the file did not arrive intact";
+		}
+		else if (test.expectNaks && result.naks == 0)
+		{
+			problem = "no damaged frame was answered with a NAK";
+		}
+		else if (test.expectSmallerFrames && noise.GetSmallestFrame() * 4 > noise.GetLargestFrame())
+		{
+			problem = "the frames did not get smaller";
+		}
+
+		printf("%s %s: %lld bytes in %lld ms, %d NAKs, frames of %d to %d bytes, %d of %d frame buffers used, "
+			"write queue up to %d bytes%s%s\n", problem ? "FAIL" : "PASS", test.name, (long long)test.size,
+			(long long)result.ms, result.naks, noise.GetSmallestFrame(), noise.GetLargestFrame(),
+			result.poolHighWaterMark, result.poolSize, result.writeQueuePeak, problem ? ", " : "", problem ? problem : "");
+		fflush(stdout);
+		failed += problem ? 1 : 0;
+	}
+
+	QFile::remove(input);
+	QFile::remove(output);
+	printf("%d of %d tests passed\n", count - failed, count);
+	return failed == 0 ? 0 : 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Runs the tests when no file is given.
+--					Oct 17, 2026 - Prints how the frame buffer pools were used.
+--					Oct 17, 2026 - Prints how deep the sender's write queue got.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		int main (int argc, char* argv[])
+--
+-- RETURNS:			0 if the file arrived intact, 1 if it did not and 2 if the arguments were wrong. With no file, 0
+--					if every test passed and otherwise 1.
+--
+-- NOTES:
+-- The I/O threads need a QApplication, because the file manipulator is a widget, so the offscreen platform is used
+-- unless another one is asked for. The protocol's debug output is turned off.
+----------------------------------------------------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+	{
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	QApplication app(argc, argv);
+	QLoggingCategory::setFilterRules("default.debug=false");
+
+	QStringList arguments = app.arguments();
+	if (arguments.size() == 1)
+	{
+		return runTests(app);
+	}
+	if (arguments.size() > 3)
+	{
+		fprintf(stderr, "usage: LoopbackDriver [file to send] [file to save it as]\n");
+		return 2;
+	}
+	QString input = arguments[1];
+	QString output = arguments.size() == 3 ? arguments[2] : QString(OUTPUT_FILE_NAME);
+	if (!QFile::exists(input))
+	{
+		fprintf(stderr, "%s does not exist\n", qPrintable(input));
+		return 2;
+	}
+
+	TransferResult result = transfer(app, input, output, LOOPBACK_PORT_NAME, IOThread::SELECTIVE_REPEAT,
+		DEFAULT_DATA_LENGTH, nullptr, TRANSFER_TIMEOUT);
+	if (!result.finished)
+	{
+		fprintf(stderr, "the transfer did not finish within %d ms\n", TRANSFER_TIMEOUT);
+		return 1;
+	}
+	if (!result.intact)
+	{
+		fprintf(stderr, "%s does not match %s\n", qPrintable(output), qPrintable(input));
+		return 1;
+	}
+
+	qint64 size = QFile(input).size();
+	printf("sent %lld bytes in %lld ms, %.2f MB/s\n", (long long)size, (long long)result.ms, size / 1000.0 / result.ms);
+	printf("frame buffers: %d of %d used at most, %d still borrowed at the end\n", result.poolHighWaterMark,
+		result.poolSize, result.poolInUse);
+	printf("write queue: up to %d bytes waiting\n", result.writeQueuePeak);
+	return 0;
+}
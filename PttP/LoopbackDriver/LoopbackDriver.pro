@@ -0,0 +1,12 @@
+# Sends a file between two I/O threads over a loopback link, without a window. See LoopbackDriver.cpp.
+# make check runs it with no file, which sends a test file over clean and damaged links.
+
+TEMPLATE = app
+TARGET = LoopbackDriver
+CONFIG += console testcase no_testcase_installs
+CONFIG -= app_bundle
+
+include(../PttP/PttP.pri)
+
+SOURCES += \
+	LoopbackDriver.cpp
@@ -0,0 +1,7 @@
+# Builds the program and the loopback driver. See PttP/PttP.pri for the options.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+	PttP \
+	LoopbackDriver
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BufferSink.cpp - A receive sink that collects received data until it is taken.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- void Write(const ByteView& data)
+-- QByteArray Take()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- The protocol thread writes the data of each frame it delivers and takes everything collected so far once the
+-- frames have been acknowledged, to hand it to the GUI thread in one piece. The bytes are kept as they arrived; they
+-- are only turned into text by whatever displays them.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "BufferSink.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Write (const ByteView& data)
+--						const ByteView& data: The data of the next frame in sequence.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Copies the data onto the end of the bytes collected so far. This is the only copy made of received data before it
+-- is taken.
+----------------------------------------------------------------------------------------------------------------------*/
+void BufferSink::Write(const ByteView& data)
+{
+	mBytes.append(data.data, data.size);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Take
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		QByteArray Take (void)
+--
+-- RETURNS:			Every byte written since the bytes were last taken.
+--
+-- NOTES:
+-- Hands over the collected bytes without copying them and starts collecting again from empty.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray BufferSink::Take()
+{
+	QByteArray bytes;
+	bytes.swap(mBytes);
+	return bytes;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "ReceiveSink.h"
+
+class BufferSink : public ReceiveSink
+{
+public:
+	void Write(const ByteView& data) override;
+	QByteArray Take();
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: IsEmpty()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: bool IsEmpty (void)
+	--
+	-- RETURNS: True if nothing has been written since the bytes were last taken.
+	-------------------------------------------------------------------------------------------------*/
+	inline bool IsEmpty() const { return mBytes.isEmpty(); }
+
+private:
+	QByteArray mBytes;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+
+/*-------------------------------------------------------------------------------------------------
+-- STRUCT: ByteView
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- A read-only view of bytes that are owned by someone else. Making or copying a view never copies
+-- the bytes, so it is only valid for as long as the owner keeps them where they are. Anything
+-- that needs the bytes for longer has to copy them.
+-------------------------------------------------------------------------------------------------*/
+struct ByteView
+{
+	const char* data;
+	int size;
+
+	ByteView() : data(nullptr), size(0) {}
+	ByteView(const char* data, const int size) : data(data), size(size) {}
+	ByteView(const QByteArray& bytes) : data(bytes.constData()), size(bytes.size()) {}
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: Mid()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: ByteView Mid (const int pos, const int length)
+	--				const int pos: The index of the first byte of the part.
+	--				const int length: The number of bytes in the part.
+	--
+	-- RETURNS: A view of part of the bytes.
+	-------------------------------------------------------------------------------------------------*/
+	inline ByteView Mid(const int pos, const int length) const { return ByteView(data + pos, length); }
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: ToByteArray()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: QByteArray ToByteArray (void)
+	--
+	-- RETURNS: A copy of the bytes.
+	-------------------------------------------------------------------------------------------------*/
+	inline QByteArray ToByteArray() const { return QByteArray(data, size); }
+
+	inline char operator[](const int i) const { return data[i]; }
+};
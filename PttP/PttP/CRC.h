@@ -47,12 +47,17 @@
                                                           may be faster on processor architectures which support single-instruction integer multiplication.
         #define CRCPP_USE_CPP11                         - Define to enables C++11 features (move semantics, constexpr, static_assert, etc.).
         #define CRCPP_INCLUDE_ESOTERIC_CRC_DEFINITIONS  - Define to include definitions for little-used CRCs. 
+        #define CRCPP_NO_CONSTEXPR_TABLES               - Define to stop CRC::StaticTable and CRC::StaticCalculator from being declared. They need C++14 and are
+                                                          otherwise declared whenever the compiler supports it.
+        #define CRCPP_NO_HARDWARE_CRC                   - Define to stop CalculateCRC32() and CalculateCRC32C() from using the PCLMULQDQ and SSE4.2
+                                                          instructions on x86 processors that support them. The lookup table is used instead.
 */
 
 #ifndef CRCPP_CRC_H_
 #define CRCPP_CRC_H_
 
 #include <climits>  // Includes CHAR_BIT
+#include <cstring>  // Includes ::std::memcpy
 #ifdef CRCPP_USE_CPP11
 #include <cstddef>  // Includes ::std::size_t
 #include <cstdint>  // Includes ::std::uint8_t, ::std::uint16_t, ::std::uint32_t, ::std::uint64_t
@@ -63,6 +68,25 @@
 #include <limits>   // Includes ::std::numeric_limits
 #include <utility>  // Includes ::std::move
 
+#if !defined(CRCPP_NO_CONSTEXPR_TABLES) && ((defined(__cplusplus) && __cplusplus >= 201402L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L))
+#   define CRCPP_CONSTEXPR_TABLES
+#endif
+
+#if !defined(CRCPP_NO_HARDWARE_CRC) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#   define CRCPP_X86_HARDWARE_CRC
+#   if defined(_MSC_VER)
+#       include <intrin.h>  // Includes __cpuid and the SSE4.2 and PCLMULQDQ intrinsics
+        /// @brief Marks a function that uses instructions beyond the baseline of the target (not needed by MSVC).
+#       define crcpp_target(features)
+#   else
+#       include <cpuid.h>     // Includes __get_cpuid
+#       include <nmmintrin.h> // Includes the SSE4.2 intrinsics
+#       include <wmmintrin.h> // Includes the PCLMULQDQ intrinsics
+        /// @brief Marks a function that uses instructions beyond the baseline of the target.
+#       define crcpp_target(features) __attribute__((target(features)))
+#   endif
+#endif
+
 #ifndef crcpp_uint8
 #   ifdef CRCPP_USE_CPP11
         /// @brief Unsigned 8-bit integer definition, used primarily for parameter definitions.
@@ -173,6 +197,8 @@ public:
 
         const CRCType * GetTable() const;
 
+        const CRCType * GetSliceTable(crcpp_uint16 slice) const;
+
         CRCType operator[](unsigned char index) const;
 
     private:
@@ -180,8 +206,49 @@ public:
 
         Parameters<CRCType, CRCWidth> parameters; ///< CRC parameters used to construct the table
         CRCType table[1 << CHAR_BIT];             ///< CRC lookup table
+        CRCType slices[7][1 << CHAR_BIT];         ///< Lookup tables for the 7 bytes after the first when slicing by 8
     };
 
+#ifdef CRCPP_CONSTEXPR_TABLES
+    /**
+        @brief CRC lookup table that is generated at compile time.
+        @note The table only depends on the polynomial, width and input reflection, so every CRC that shares those
+            shares one table. Slice n gives the effect of a byte followed by n zero bytes, for processing 8 bytes at a time.
+    */
+    template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, bool ReflectInput>
+    struct StaticTable
+    {
+        constexpr StaticTable();
+
+        constexpr const CRCType * GetSliceTable(crcpp_uint16 slice) const;
+
+        constexpr CRCType operator[](unsigned char index) const;
+
+    private:
+        CRCType slices[8][1 << CHAR_BIT]; ///< CRC lookup tables, one for each byte of an 8 byte block
+    };
+
+    /**
+        @brief CRC calculator with the parameters and lookup table fixed at compile time.
+        @note The lookup table is a constant generated by the compiler, so there is nothing to initialize on first use and the
+            inner loop does not branch on any parameter. Reflected 32 bit CRCs are calculated 8 bytes at a time.
+    */
+    template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, CRCType InitialValue, CRCType FinalXOR, bool ReflectInput, bool ReflectOutput>
+    struct StaticCalculator
+    {
+        static CRCType Calculate(const void * data, crcpp_size size);
+
+        static CRCType Calculate(const void * data, crcpp_size size, CRCType crc);
+
+        static CRCType CalculateRemainder(const void * data, crcpp_size size, CRCType remainder);
+
+        static constexpr StaticTable<CRCType, CRCWidth, Polynomial, ReflectInput> table = StaticTable<CRCType, CRCWidth, Polynomial, ReflectInput>();
+    };
+
+    /// @brief CRC-32 with its lookup table generated at compile time. Gives the same result as CRC_32().
+    typedef StaticCalculator<crcpp_uint32, 32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true> StaticCRC_32;
+#endif
+
     // The number of bits in CRCType must be at least as large as CRCWidth.
     // CRCType must be an unsigned integer type or a custom type with operator overloads.
     template <typename CRCType, crcpp_uint16 CRCWidth>
@@ -196,6 +263,11 @@ public:
     template <typename CRCType, crcpp_uint16 CRCWidth>
     static CRCType Calculate(const void * data, crcpp_size size, const Table<CRCType, CRCWidth> & lookupTable, CRCType crc);
 
+    // CRC-32 and CRC-32C using the fastest implementation the processor supports, picked the first time each is called.
+    static crcpp_uint32 CalculateCRC32(const void * data, crcpp_size size, crcpp_uint32 crc = 0);
+
+    static crcpp_uint32 CalculateCRC32C(const void * data, crcpp_size size, crcpp_uint32 crc = 0);
+
     // Common CRCs up to 64 bits.
     // Note: Check values are the computed CRCs when given an ASCII input of "123456789" (without null terminator)
 #ifdef CRCPP_INCLUDE_ESOTERIC_CRC_DEFINITIONS
@@ -295,6 +367,21 @@ private:
 
     template <typename IntegerType>
     static crcpp_constexpr IntegerType BoundedConstexprValue(IntegerType x);
+
+    typedef crcpp_uint32 (*RemainderFunction32)(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder);
+
+    static RemainderFunction32 SelectCRC32Remainder();
+    static RemainderFunction32 SelectCRC32CRemainder();
+
+    static crcpp_uint32 CalculateCRC32Remainder(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder);
+    static crcpp_uint32 CalculateCRC32CRemainder(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder);
+
+#ifdef CRCPP_X86_HARDWARE_CRC
+    static void GetProcessorFeatures(bool & pclmulqdq, bool & sse42);
+
+    static crcpp_uint32 CalculateCRC32RemainderPCLMULQDQ(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder);
+    static crcpp_uint32 CalculateCRC32CRemainderSSE42(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder);
+#endif
 };
 
 /**
@@ -364,6 +451,21 @@ inline const CRCType * CRC::Table<CRCType, CRCWidth>::GetTable() const
     return table;
 }
 
+/**
+    @brief Gets one of the tables used to process 8 bytes at a time
+    @note Slice 0 is the CRC table itself. Slice n gives the effect of a byte followed by n zero bytes.
+        The slices past 0 are only filled in for reflected CRCs.
+    @param[in] slice Index of the table, from 0 to 7
+    @tparam CRCType Integer type for storing the CRC result
+    @tparam CRCWidth Number of bits in the CRC
+    @return CRC table for that slice
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth>
+inline const CRCType * CRC::Table<CRCType, CRCWidth>::GetSliceTable(crcpp_uint16 slice) const
+{
+    return slice == 0 ? table : slices[slice - 1];
+}
+
 /**
     @brief Gets an entry in the CRC table
     @param[in] index Index into the CRC table
@@ -414,8 +516,217 @@ inline void CRC::Table<CRCType, CRCWidth>::InitTable()
         table[byte] = crc;
     }
     while (++byte);
+
+    // Each slice extends the one before it by a zero byte, so slice n is a byte followed by n zero bytes.
+    if (parameters.reflectInput)
+    {
+        const CRCType * previous = table;
+        for (crcpp_uint16 slice = 0; slice < 7; ++slice)
+        {
+            do
+            {
+#if defined(WIN32) || defined(_WIN32) || defined(WINCE)
+#   pragma warning (push)
+#   pragma warning (disable : 4333)
+#endif
+                slices[slice][byte] = (previous[byte] >> CHAR_BIT) ^ table[static_cast<unsigned char>(previous[byte])];
+#if defined(WIN32) || defined(_WIN32) || defined(WINCE)
+#   pragma warning (pop)
+#endif
+            }
+            while (++byte);
+
+            previous = slices[slice];
+        }
+    }
+}
+
+#ifdef CRCPP_CONSTEXPR_TABLES
+/**
+    @brief Generates a CRC lookup table at compile time.
+    @tparam CRCType Integer type for storing the CRC result
+    @tparam CRCWidth Number of bits in the CRC
+    @tparam Polynomial CRC polynomial
+    @tparam ReflectInput true if input bytes are reflected
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, bool ReflectInput>
+inline constexpr CRC::StaticTable<CRCType, CRCWidth, Polynomial, ReflectInput>::StaticTable() :
+    slices()
+{
+    static_assert(::std::numeric_limits<CRCType>::digits >= CRCWidth, "CRCType is too small to contain a CRC of width CRCWidth.");
+    static_assert(CRCWidth >= CHAR_BIT, "StaticTable does not support CRCs narrower than a byte.");
+
+    constexpr CRCType BIT_MASK((CRCType(1) << (CRCWidth - CRCType(1))) |
+                               ((CRCType(1) << (CRCWidth - CRCType(1))) - CRCType(1)));
+    constexpr CRCType HIGHEST_BIT_MASK(CRCType(1) << (CRCWidth - CRCType(1)));
+    constexpr crcpp_uint16 SHIFT(CRCWidth - CHAR_BIT);
+
+    CRCType reflectedPolynomial(0);
+    for (crcpp_uint16 i = 0; i < CRCWidth; ++i)
+    {
+        reflectedPolynomial |= ((Polynomial >> i) & 1) << (CRCWidth - 1 - i);
+    }
+
+    for (unsigned int byte = 0; byte < (1u << CHAR_BIT); ++byte)
+    {
+        CRCType remainder(0);
+
+        if (ReflectInput)
+        {
+            remainder = static_cast<CRCType>(byte);
+            for (crcpp_size i = 0; i < CHAR_BIT; ++i)
+            {
+                remainder = (remainder & 1) ? ((remainder >> 1) ^ reflectedPolynomial) : (remainder >> 1);
+            }
+        }
+        else
+        {
+            remainder = static_cast<CRCType>(static_cast<CRCType>(byte) << SHIFT);
+            for (crcpp_size i = 0; i < CHAR_BIT; ++i)
+            {
+                remainder = (remainder & HIGHEST_BIT_MASK) ? ((remainder << 1) ^ Polynomial) : (remainder << 1);
+            }
+        }
+
+        slices[0][byte] = remainder & BIT_MASK;
+    }
+
+    for (crcpp_uint16 slice = 1; slice < 8; ++slice)
+    {
+        for (unsigned int byte = 0; byte < (1u << CHAR_BIT); ++byte)
+        {
+            CRCType previous = slices[slice - 1][byte];
+
+            if (ReflectInput)
+            {
+                slices[slice][byte] = (previous >> CHAR_BIT) ^ slices[0][previous & 0xFF];
+            }
+            else
+            {
+                slices[slice][byte] = ((previous << CHAR_BIT) ^ slices[0][(previous >> SHIFT) & 0xFF]) & BIT_MASK;
+            }
+        }
+    }
+}
+
+/**
+    @brief Gets one of the tables used to process 8 bytes at a time
+    @param[in] slice Index of the table, from 0 to 7
+    @tparam CRCType Integer type for storing the CRC result
+    @tparam CRCWidth Number of bits in the CRC
+    @tparam Polynomial CRC polynomial
+    @tparam ReflectInput true if input bytes are reflected
+    @return CRC table for that slice
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, bool ReflectInput>
+inline constexpr const CRCType * CRC::StaticTable<CRCType, CRCWidth, Polynomial, ReflectInput>::GetSliceTable(crcpp_uint16 slice) const
+{
+    return slices[slice];
+}
+
+/**
+    @brief Gets an entry in the CRC table
+    @param[in] index Index into the CRC table
+    @tparam CRCType Integer type for storing the CRC result
+    @tparam CRCWidth Number of bits in the CRC
+    @tparam Polynomial CRC polynomial
+    @tparam ReflectInput true if input bytes are reflected
+    @return CRC table entry
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, bool ReflectInput>
+inline constexpr CRCType CRC::StaticTable<CRCType, CRCWidth, Polynomial, ReflectInput>::operator[](unsigned char index) const
+{
+    return slices[0][index];
 }
 
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, CRCType InitialValue, CRCType FinalXOR, bool ReflectInput, bool ReflectOutput>
+constexpr CRC::StaticTable<CRCType, CRCWidth, Polynomial, ReflectInput> CRC::StaticCalculator<CRCType, CRCWidth, Polynomial, InitialValue, FinalXOR, ReflectInput, ReflectOutput>::table;
+
+/**
+    @brief Computes a CRC with the lookup table generated at compile time.
+    @param[in] data Data over which CRC will be computed
+    @param[in] size Size of the data
+    @return CRC
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, CRCType InitialValue, CRCType FinalXOR, bool ReflectInput, bool ReflectOutput>
+inline CRCType CRC::StaticCalculator<CRCType, CRCWidth, Polynomial, InitialValue, FinalXOR, ReflectInput, ReflectOutput>::Calculate(const void * data, crcpp_size size)
+{
+    CRCType remainder = CalculateRemainder(data, size, InitialValue);
+
+    return Finalize<CRCType, CRCWidth>(remainder, FinalXOR, ReflectInput != ReflectOutput);
+}
+
+/**
+    @brief Appends additional data to a previous CRC calculation with the lookup table generated at compile time.
+    @param[in] data Data over which CRC will be computed
+    @param[in] size Size of the data
+    @param[in] crc CRC from a previous calculation
+    @return CRC
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, CRCType InitialValue, CRCType FinalXOR, bool ReflectInput, bool ReflectOutput>
+inline CRCType CRC::StaticCalculator<CRCType, CRCWidth, Polynomial, InitialValue, FinalXOR, ReflectInput, ReflectOutput>::Calculate(const void * data, crcpp_size size, CRCType crc)
+{
+    CRCType remainder = UndoFinalize<CRCType, CRCWidth>(crc, FinalXOR, ReflectInput != ReflectOutput);
+
+    remainder = CalculateRemainder(data, size, remainder);
+
+    return Finalize<CRCType, CRCWidth>(remainder, FinalXOR, ReflectInput != ReflectOutput);
+}
+
+/**
+    @brief Computes a CRC remainder with the lookup table generated at compile time.
+    @note Every parameter is a template argument, so the compiler drops the branches that do not apply.
+    @param[in] data Data over which the remainder will be computed
+    @param[in] size Size of the data
+    @param[in] remainder Running CRC remainder
+    @return CRC remainder
+*/
+template <typename CRCType, crcpp_uint16 CRCWidth, CRCType Polynomial, CRCType InitialValue, CRCType FinalXOR, bool ReflectInput, bool ReflectOutput>
+inline CRCType CRC::StaticCalculator<CRCType, CRCWidth, Polynomial, InitialValue, FinalXOR, ReflectInput, ReflectOutput>::CalculateRemainder(const void * data, crcpp_size size, CRCType remainder)
+{
+    static constexpr CRCType SHIFT(CRCWidth - CHAR_BIT);
+
+    const unsigned char * current = reinterpret_cast<const unsigned char *>(data);
+
+    if (ReflectInput)
+    {
+        if (CRCWidth == 32)
+        {
+            while (size >= 8)
+            {
+                crcpp_uint32 low = static_cast<crcpp_uint32>(remainder) ^
+                                   (static_cast<crcpp_uint32>(current[0])       |
+                                    static_cast<crcpp_uint32>(current[1]) << 8  |
+                                    static_cast<crcpp_uint32>(current[2]) << 16 |
+                                    static_cast<crcpp_uint32>(current[3]) << 24);
+
+                remainder = table.GetSliceTable(7)[low & 0xFF]         ^ table.GetSliceTable(6)[(low >> 8) & 0xFF] ^
+                            table.GetSliceTable(5)[(low >> 16) & 0xFF] ^ table.GetSliceTable(4)[low >> 24]         ^
+                            table.GetSliceTable(3)[current[4]]         ^ table.GetSliceTable(2)[current[5]]        ^
+                            table.GetSliceTable(1)[current[6]]         ^ table.GetSliceTable(0)[current[7]];
+
+                current += 8;
+                size -= 8;
+            }
+        }
+
+        while (size--)
+        {
+            remainder = (remainder >> CHAR_BIT) ^ table[static_cast<unsigned char>(remainder ^ *current++)];
+        }
+    }
+    else
+    {
+        while (size--)
+        {
+            remainder = (remainder << CHAR_BIT) ^ table[static_cast<unsigned char>((remainder >> SHIFT) ^ *current++)];
+        }
+    }
+
+    return remainder;
+}
+#endif
+
 /**
     @brief Computes a CRC.
     @param[in] data Data over which CRC will be computed
@@ -712,6 +1023,37 @@ inline CRCType CRC::CalculateRemainder(const void * data, crcpp_size size, const
 
     if (lookupTable.GetParameters().reflectInput)
     {
+        // Slicing-by-8: fold 8 bytes into the remainder with 8 independent lookups instead of 8 dependent ones.
+        // The first 4 bytes are XORed into the remainder one byte at a time so the result does not depend on byte order.
+        if (CRCWidth == 32)
+        {
+            const CRCType * slice0 = lookupTable.GetSliceTable(0);
+            const CRCType * slice1 = lookupTable.GetSliceTable(1);
+            const CRCType * slice2 = lookupTable.GetSliceTable(2);
+            const CRCType * slice3 = lookupTable.GetSliceTable(3);
+            const CRCType * slice4 = lookupTable.GetSliceTable(4);
+            const CRCType * slice5 = lookupTable.GetSliceTable(5);
+            const CRCType * slice6 = lookupTable.GetSliceTable(6);
+            const CRCType * slice7 = lookupTable.GetSliceTable(7);
+
+            while (size >= 8)
+            {
+                crcpp_uint32 low = static_cast<crcpp_uint32>(remainder) ^
+                                   (static_cast<crcpp_uint32>(current[0])       |
+                                    static_cast<crcpp_uint32>(current[1]) << 8  |
+                                    static_cast<crcpp_uint32>(current[2]) << 16 |
+                                    static_cast<crcpp_uint32>(current[3]) << 24);
+
+                remainder = slice7[low & 0xFF]         ^ slice6[(low >> 8) & 0xFF] ^
+                            slice5[(low >> 16) & 0xFF] ^ slice4[low >> 24]         ^
+                            slice3[current[4]]         ^ slice2[current[5]]        ^
+                            slice1[current[6]]         ^ slice0[current[7]];
+
+                current += 8;
+                size -= 8;
+            }
+        }
+
         while (size--)
         {
 #if defined(WIN32) || defined(_WIN32) || defined(WINCE)
@@ -754,6 +1096,297 @@ inline CRCType CRC::CalculateRemainder(const void * data, crcpp_size size, const
     return remainder;
 }
 
+/**
+    @brief Computes a CRC-32 using the fastest implementation the processor supports.
+    @note The implementation is picked the first time this function is called. Processors with PCLMULQDQ use
+        carry-less multiplication to fold 64 bytes at a time, anything else uses a slicing-by-8 lookup table.
+    @note Passing a CRC from a previous calculation appends to it. The default of 0 is the CRC of no data,
+        so it starts a new calculation.
+    @param[in] data Data over which CRC will be computed
+    @param[in] size Size of the data
+    @param[in] crc CRC from a previous calculation
+    @return CRC-32
+*/
+inline crcpp_uint32 CRC::CalculateCRC32(const void * data, crcpp_size size, crcpp_uint32 crc)
+{
+    static const RemainderFunction32 calculateRemainder = SelectCRC32Remainder();
+
+    return ~calculateRemainder(reinterpret_cast<const unsigned char *>(data), size, ~crc);
+}
+
+/**
+    @brief Computes a CRC-32C (Castagnoli) using the fastest implementation the processor supports.
+    @note The implementation is picked the first time this function is called. Processors with SSE4.2 use
+        the crc32 instruction, anything else uses a slicing-by-8 lookup table.
+    @note Passing a CRC from a previous calculation appends to it. The default of 0 is the CRC of no data,
+        so it starts a new calculation.
+    @param[in] data Data over which CRC will be computed
+    @param[in] size Size of the data
+    @param[in] crc CRC from a previous calculation
+    @return CRC-32C
+*/
+inline crcpp_uint32 CRC::CalculateCRC32C(const void * data, crcpp_size size, crcpp_uint32 crc)
+{
+    static const RemainderFunction32 calculateRemainder = SelectCRC32CRemainder();
+
+    return ~calculateRemainder(reinterpret_cast<const unsigned char *>(data), size, ~crc);
+}
+
+/**
+    @brief Picks the function used by CalculateCRC32() to compute a remainder.
+    @return Remainder function
+*/
+inline CRC::RemainderFunction32 CRC::SelectCRC32Remainder()
+{
+#ifdef CRCPP_X86_HARDWARE_CRC
+    bool pclmulqdq;
+    bool sse42;
+
+    GetProcessorFeatures(pclmulqdq, sse42);
+
+    // The folding kernel also uses an SSE4.1 instruction, which every processor with SSE4.2 has.
+    if (pclmulqdq && sse42)
+    {
+        return &CalculateCRC32RemainderPCLMULQDQ;
+    }
+#endif
+
+    return &CalculateCRC32Remainder;
+}
+
+/**
+    @brief Picks the function used by CalculateCRC32C() to compute a remainder.
+    @return Remainder function
+*/
+inline CRC::RemainderFunction32 CRC::SelectCRC32CRemainder()
+{
+#ifdef CRCPP_X86_HARDWARE_CRC
+    bool pclmulqdq;
+    bool sse42;
+
+    GetProcessorFeatures(pclmulqdq, sse42);
+
+    if (sse42)
+    {
+        return &CalculateCRC32CRemainderSSE42;
+    }
+#endif
+
+    return &CalculateCRC32CRemainder;
+}
+
+/**
+    @brief Computes a CRC-32 remainder with a lookup table.
+    @param[in] data Data over which the remainder will be computed
+    @param[in] size Size of the data
+    @param[in] remainder Running CRC remainder
+    @return CRC remainder
+*/
+inline crcpp_uint32 CRC::CalculateCRC32Remainder(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder)
+{
+#ifdef CRCPP_CONSTEXPR_TABLES
+    return StaticCRC_32::CalculateRemainder(data, size, remainder);
+#else
+    static const Table<crcpp_uint32, 32> lookupTable(CRC_32());
+
+    return CalculateRemainder(data, size, lookupTable, remainder);
+#endif
+}
+
+/**
+    @brief Computes a CRC-32C remainder with a lookup table.
+    @param[in] data Data over which the remainder will be computed
+    @param[in] size Size of the data
+    @param[in] remainder Running CRC remainder
+    @return CRC remainder
+*/
+inline crcpp_uint32 CRC::CalculateCRC32CRemainder(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder)
+{
+#ifdef CRCPP_CONSTEXPR_TABLES
+    return StaticCalculator<crcpp_uint32, 32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true, true>::CalculateRemainder(data, size, remainder);
+#else
+    static const Parameters<crcpp_uint32, 32> parameters = { 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true, true };
+    static const Table<crcpp_uint32, 32> lookupTable(parameters);
+
+    return CalculateRemainder(data, size, lookupTable, remainder);
+#endif
+}
+
+#ifdef CRCPP_X86_HARDWARE_CRC
+/**
+    @brief Checks which CRC instructions the processor supports.
+    @param[out] pclmulqdq Set to true if the processor supports PCLMULQDQ
+    @param[out] sse42 Set to true if the processor supports SSE4.2
+*/
+inline void CRC::GetProcessorFeatures(bool & pclmulqdq, bool & sse42)
+{
+    unsigned int ecx = 0;
+
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 1);
+    ecx = static_cast<unsigned int>(registers[2]);
+#else
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        ecx = 0;
+    }
+#endif
+
+    pclmulqdq = (ecx & (1u << 1)) != 0;
+    sse42 = (ecx & (1u << 20)) != 0;
+}
+
+/**
+    @brief Computes a CRC-32 remainder by folding with carry-less multiplication.
+    @note Follows "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).
+        Four 128 bit lanes are folded 64 bytes at a time, folded into one lane, then reduced to 32 bits with
+        a Barrett reduction. Data shorter than 64 bytes and the last bytes that do not fill a lane use the lookup table.
+    @param[in] data Data over which the remainder will be computed
+    @param[in] size Size of the data
+    @param[in] remainder Running CRC remainder
+    @return CRC remainder
+*/
+crcpp_target("pclmul,sse4.1")
+inline crcpp_uint32 CRC::CalculateCRC32RemainderPCLMULQDQ(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder)
+{
+    if (size < 64)
+    {
+        return CalculateCRC32Remainder(data, size, remainder);
+    }
+
+    // Fold constants for the reflected polynomial 0x04C11DB7: x^(4*128+64), x^(4*128), x^(128+64), x^128, x^64,
+    // and the Barrett constants mu and P(x).
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000LL, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30));
+    __m128i x5;
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(remainder)));
+
+    data += 64;
+    size -= 64;
+
+    // Fold 4 lanes at a time.
+    while (size >= 64)
+    {
+        __m128i x6, x7, x8;
+
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30)));
+
+        data += 64;
+        size -= 64;
+    }
+
+    // Fold the 4 lanes into 1.
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Fold in whatever 16 byte blocks are left.
+    while (size >= 16)
+    {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data))), x5);
+
+        data += 16;
+        size -= 16;
+    }
+
+    // Fold 128 bits down to 64.
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction down to 32 bits.
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    remainder = static_cast<crcpp_uint32>(_mm_extract_epi32(x1, 1));
+
+    return CalculateCRC32Remainder(data, size, remainder);
+}
+
+/**
+    @brief Computes a CRC-32C remainder with the SSE4.2 crc32 instruction.
+    @param[in] data Data over which the remainder will be computed
+    @param[in] size Size of the data
+    @param[in] remainder Running CRC remainder
+    @return CRC remainder
+*/
+crcpp_target("sse4.2")
+inline crcpp_uint32 CRC::CalculateCRC32CRemainderSSE42(const unsigned char * data, crcpp_size size, crcpp_uint32 remainder)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    crcpp_uint64 remainder64 = remainder;
+    while (size >= 8)
+    {
+        crcpp_uint64 block;
+        ::std::memcpy(&block, data, sizeof(block));
+        remainder64 = _mm_crc32_u64(remainder64, block);
+        data += 8;
+        size -= 8;
+    }
+    remainder = static_cast<crcpp_uint32>(remainder64);
+#endif
+
+    while (size >= 4)
+    {
+        crcpp_uint32 block;
+        ::std::memcpy(&block, data, sizeof(block));
+        remainder = _mm_crc32_u32(remainder, block);
+        data += 4;
+        size -= 4;
+    }
+
+    while (size--)
+    {
+        remainder = _mm_crc32_u8(remainder, *data++);
+    }
+
+    return remainder;
+}
+#endif
+
 /**
     @brief Function to force a compile-time expression to be >= 0.
     @note This function is used to avoid compiler warnings because all constexpr values are evaluated
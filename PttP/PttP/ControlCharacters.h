@@ -6,5 +6,6 @@
 #define ENQ 0x05
 #define EOT 0x04
 #define RVI 0x07
+#define NAK 0x15
 
 
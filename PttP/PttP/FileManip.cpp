@@ -4,14 +4,21 @@
 -- PROGRAM: PttP
 --
 -- FUNCTIONS:
--- QByteArray GetNextBytes()
--- QByteArray GetPreviousBytes()
--- bool IsAtEndOfFile()
+-- FileChunk GetNextChunk(const int maxLength)
+-- ByteView GetChunk(const FileChunk& chunk)
+-- void SetPosition(const qint64 position)
 -- void SelectFile()
+-- void Select(const QString& name)
+-- void Open(const QString& name)
+-- void readBlock(const qint64 offset, const qint64 end)
+-- void close()
 --
 -- DATE: Nov 29, 2017
 --
--- REVISIONS: N/A
+-- REVISIONS: Oct 16, 2026 - Reads the file through a memory mapping instead of a stream.
+--            Oct 16, 2026 - Keeps the last few blocks read in a cache when the file is not mapped.
+--            Oct 16, 2026 - Replaced IsAtEndOfFile with SetPosition for the frame prefetcher.
+--            Oct 17, 2026 - Keeps only the last block read instead of a cache of blocks.
 --
 -- DESIGNER: Benny Wang, Delan Elliot
 --
@@ -19,15 +26,26 @@
 --
 -- NOTES:
 -- This class handles opening/closing of a file as well as reading bytes from it and keeping track of the file pointer.
+--
+-- The selected file is mapped into memory, so any part of it can be handed out as a view without copying it or making
+-- a system call. The sender only keeps the offset and length of each frame it has in flight and asks for the bytes
+-- again when it builds the frame. If the file cannot be mapped it is read in large blocks that start on an aligned
+-- offset, and chunks are handed out of the last block read. Chunks are only asked for in order, since a resent frame
+-- is sent again from the buffer it was built in, so one block is all that is needed.
 ----------------------------------------------------------------------------------------------------------------------*/
 #include "FileManip.h"
 
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 /*-------------------------------------------------------------------------------------------------
 -- FUNCTION: FileManip
 --
 -- DATE:		November 29, 2017
 --
--- REVISIONS:	N/A
+-- REVISIONS:	Oct 16, 2026 - Starts with no file mapped.
 --
 -- DESIGNER:	Benny Wang
 --
@@ -45,7 +63,10 @@
 -------------------------------------------------------------------------------------------------*/
 FileManip::FileManip(QObject* parent)
 	: mFile("")
-	, mInStream(make_unique<ifstream>())
+	, mMap(nullptr)
+	, mSize(0)
+	, mPosition(0)
+	, mBlockOffset(0)
 { 
 }
 
@@ -54,7 +75,7 @@ FileManip::FileManip(QObject* parent)
 --
 -- DATE:		November 29, 2017
 --
--- REVISIONS:	N/A
+-- REVISIONS:	Oct 16, 2026 - Unmaps and closes the file.
 --
 -- DESIGNER:	Benny Wang
 --
@@ -67,11 +88,11 @@ FileManip::FileManip(QObject* parent)
 -- NOTES:
 -- Deconstructor.
 --
--- Closes the ifstream.
+-- Unmaps and closes the file.
 -------------------------------------------------------------------------------------------------*/
 FileManip::~FileManip()
 {
-	mInStream->close();
+	close();
 }
 
 /*-------------------------------------------------------------------------------------------------
@@ -79,7 +100,9 @@ FileManip::~FileManip()
 --
 -- DATE:		November 29, 2017
 --
--- REVISIONS:	N/A
+-- REVISIONS:	Oct 16, 2026 - Maps the file into memory, or falls back to reading it in blocks.
+--				Oct 16, 2026 - Leaves opening the file to the thread that reads it.
+--				Oct 16, 2026 - Passes the name on through Select.
 --
 -- DESIGNER:	Benny Wang
 --
@@ -96,6 +119,8 @@ FileManip::~FileManip()
 -- Opens a QFileDialog to retrieve the filename of the file that the user wants to transfer and
 -- saves it to an instance variable of this class. After that the new file name is emiited so that
 -- it can be displayed.
+--
+-- The name is then passed on by Select.
 -------------------------------------------------------------------------------------------------*/
 void FileManip::SelectFile()
 {
@@ -106,74 +131,250 @@ void FileManip::SelectFile()
 		tr("Text File ( *.txt)")		// File types
 	).toStdString();
 
-	mInStream->open(mFile, fstream::in | fstream::binary);
+	Select(QString::fromStdString(mFile));
+}
 
+/*-------------------------------------------------------------------------------------------------
+-- FUNCTION: Select()
+--
+-- DATE:		Oct 16, 2026
+--
+-- REVISIONS:	N/A
+--
+-- DESIGNER:	Benny Wang
+--
+-- PROGRAMMER:	Benny Wang 
+--
+-- INTERFACE:	void Select (const QString& name)
+--					const QString& name: The path of the file to send.
+--
+-- RETURNS:		void.
+--
+-- NOTES:
+--
+-- Makes the file the one to send without asking the user, and emits the new file name so that it
+-- can be displayed.
+--
+-- The file is not opened here, since the frame prefetcher may be reading the current one. The name
+-- is passed on with fileSelected and the file is opened by Open on the I/O thread.
+-------------------------------------------------------------------------------------------------*/
+void FileManip::Select(const QString& name)
+{
+	mFile = name.toStdString();
+	emit fileSelected(name);
 	emit fileChanged(mFile);
 }
 
+/*-------------------------------------------------------------------------------------------------
+-- FUNCTION: Open()
+--
+-- DATE:		Oct 16, 2026
+--
+-- REVISIONS:	N/A
+--
+-- DESIGNER:	Benny Wang
+--
+-- PROGRAMMER:	Benny Wang 
+--
+-- INTERFACE:	void Open (const QString& name)
+--					const QString& name: The path of the file to open.
+--
+-- RETURNS:		void.
+--
+-- NOTES:
+--
+-- The previous file is closed and the new one is mapped in one piece. The operating system is told
+-- that it will be read from start to end so it can read ahead of the sender. If the file cannot be
+-- opened no file is left open.
+--
+-- Must not be called while the file is being read, see FramePrefetcher::SetFile.
+-------------------------------------------------------------------------------------------------*/
+void FileManip::Open(const QString& name)
+{
+	close();
+	mSource.setFileName(name);
+	if (mSource.open(QIODevice::ReadOnly))
+	{
+		mSize = mSource.size();
+		if (mSize > 0)
+		{
+			mMap = (const char*)mSource.map(0, mSize);
+		}
+#ifdef Q_OS_UNIX
+		if (mMap != nullptr)
+		{
+			madvise((void*)mMap, mSize, MADV_SEQUENTIAL);
+		}
+		else
+		{
+			posix_fadvise(mSource.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+		}
+#endif
+	}
+}
 
 /*-------------------------------------------------------------------------------------------------
--- FUNCTION: GetNextBytes()
+-- FUNCTION: GetNextChunk()
 --
--- DATE:		November 29, 2017
+-- DATE:		Oct 16, 2026
 --
 -- REVISIONS:	N/A
 --
--- DESIGNER:	Benny Wang, Delan Elliot
+-- DESIGNER:	Benny Wang
 --
 -- PROGRAMMER:	Benny Wang 
 --
--- INTERFACE:	QByteArray GetNextBytes (const int)
---					const int numOfBytes: The number of bytes you want to read from the file.
+-- INTERFACE:	FileChunk GetNextChunk (const int maxLength)
+--					const int maxLength: The largest number of bytes the chunk may have.
 --
--- RETURNS:		The number of bytes the user requested from the current file pointer.
+-- RETURNS:		The offset and length of the next chunk of the file.
 --
 -- NOTES:
 --
--- Read 512 bytes from the current file position.
--- 
--- The bytes read are also saved to a buffer and can be retrieved again using GetPreviousBytes().
+-- Takes up to maxLength bytes from the current file position and moves the position past them.
+-- Nothing is read; the bytes are fetched with GetChunk when they are needed. The chunk is empty
+-- once the whole file has been taken.
 -------------------------------------------------------------------------------------------------*/
-QByteArray FileManip::GetNextBytes()
+FileChunk FileManip::GetNextChunk(const int maxLength)
 {
-	mInStream->get(mBuffer, 512, EOF);
-	return QByteArray(mBuffer);
+	FileChunk chunk;
+	chunk.offset = mPosition;
+	chunk.length = (int)qMin((qint64)maxLength, mSize - mPosition);
+	mPosition += chunk.length;
+	return chunk;
 }
 
 /*-------------------------------------------------------------------------------------------------
--- FUNCTION: GetPreviousBytes()
+-- FUNCTION: GetChunk()
 --
--- DATE:		November 29, 2017
+-- DATE:		Oct 16, 2026
 --
--- REVISIONS:	 N/A
+-- REVISIONS:	Oct 16, 2026 - Looks for the chunk in the cached blocks before reading.
+--				Oct 17, 2026 - Looks for the chunk in the last block read.
 --
 -- DESIGNER:	Benny Wang
 --
 -- PROGRAMMER:	Benny Wang 
 --
--- INTERFACE:	QByteArray GetPreviousBytes ()
+-- INTERFACE:	ByteView GetChunk (const FileChunk& chunk)
+--					const FileChunk& chunk: The offset and length of the bytes to get.
 --
--- RETURNS:		The last array of bytes requested from the FileManip
+-- RETURNS:		A view of the bytes of the chunk.
 --
 -- NOTES:
 --
--- Gives the users the same bytes that the previous GetNextByte call returned. This is used for
--- retransmission.
+-- Gets the bytes of any part of the file. If the file is mapped the view points straight into
+-- the mapping and stays valid until another file is selected.
+--
+-- Otherwise the view points into the last block read, which is only valid until the next call.
+-- If the chunk is not in that block a new one is read, so chunks that are taken in order only
+-- cost a read every few hundred frames. If the read comes up short the view is cut short as well.
 -------------------------------------------------------------------------------------------------*/
-QByteArray FileManip::GetPreviousBytes()
+ByteView FileManip::GetChunk(const FileChunk& chunk)
 {
-	return QByteArray(mBuffer);
+	if (mMap != nullptr)
+	{
+		return ByteView(mMap + chunk.offset, chunk.length);
+	}
+
+	readBlock(chunk.offset, chunk.offset + chunk.length);
+	int offset = (int)(chunk.offset - mBlockOffset);
+	return ByteView(mBlock.constData() + offset, qBound(0, mBlock.size() - offset, chunk.length));
 }
 
-bool FileManip::IsAtEndOfFile()
+/*-------------------------------------------------------------------------------------------------
+-- FUNCTION: readBlock()
+--
+-- DATE:		Oct 16, 2026
+--
+-- REVISIONS:	Oct 17, 2026 - Reads into the one block that is kept instead of a cache of blocks.
+--
+-- DESIGNER:	Benny Wang
+--
+-- PROGRAMMER:	Benny Wang 
+--
+-- INTERFACE:	void readBlock (const qint64 offset, const qint64 end)
+--					const qint64 offset: The offset of the first byte that is needed.
+--					const qint64 end: The offset after the last byte that is needed.
+--
+-- RETURNS:		void.
+--
+-- NOTES:
+--
+-- Makes sure the block holds the bytes, or as many of them as could be read. If it does not
+-- already hold them, READ_AHEAD_SIZE bytes, or more if the chunk needs it, are read into it
+-- starting on a READ_ALIGNMENT boundary. The buffer of the block is reused for every read.
+-------------------------------------------------------------------------------------------------*/
+void FileManip::readBlock(const qint64 offset, const qint64 end)
 {
-	bool result = mInStream->eof();
+	if (offset >= mBlockOffset && end <= mBlockOffset + mBlock.size())
+	{
+		return;
+	}
+
+	mBlockOffset = offset & ~(qint64)(READ_ALIGNMENT - 1);
+	qint64 length = qMin(qMax((qint64)READ_AHEAD_SIZE, end - mBlockOffset), mSize - mBlockOffset);
+	mBlock.resize((int)length);
+	qint64 read = mSource.seek(mBlockOffset) ? mSource.read(mBlock.data(), length) : -1;
+	mBlock.resize((int)qMax((qint64)0, read));
+}
 
-	if (result)
+/*-------------------------------------------------------------------------------------------------
+-- FUNCTION: SetPosition()
+--
+-- DATE:		Oct 16, 2026
+--
+-- REVISIONS:	N/A
+--
+-- DESIGNER:	Benny Wang
+--
+-- PROGRAMMER:	Benny Wang 
+--
+-- INTERFACE:	void SetPosition (const qint64 position)
+--					const qint64 position: The offset the next chunk starts at.
+--
+-- RETURNS:		void.
+--
+-- NOTES:
+--
+-- Moves the file position so the next chunk starts at position, which is kept inside the file.
+-- The frame prefetcher uses this to go back to the start of the file once it has been sent and
+-- to build frames again after the ones it built ahead were thrown away.
+-------------------------------------------------------------------------------------------------*/
+void FileManip::SetPosition(const qint64 position)
+{
+	mPosition = qBound((qint64)0, position, mSize);
+}
+
+/*-------------------------------------------------------------------------------------------------
+-- FUNCTION: close()
+--
+-- DATE:		Oct 16, 2026
+--
+-- REVISIONS:	Oct 17, 2026 - Empties the one block that is kept instead of a cache.
+--
+-- DESIGNER:	Benny Wang
+--
+-- PROGRAMMER:	Benny Wang 
+--
+-- INTERFACE:	void close (void)
+--
+-- RETURNS:		void.
+--
+-- NOTES:
+--
+-- Unmaps and closes the current file, empties the block and goes back to the start.
+-------------------------------------------------------------------------------------------------*/
+void FileManip::close()
+{
+	if (mMap != nullptr)
 	{
-		mInStream->clear();
-		mInStream->seekg(0, ios::beg);
+		mSource.unmap((uchar*)mMap);
+		mMap = nullptr;
 	}
-	
-	return result;
-}
\ No newline at end of file
+	mSource.close();
+	mSize = 0;
+	mPosition = 0;
+	mBlock.resize(0);
+	mBlockOffset = 0;
+}
@@ -1,16 +1,26 @@
 #pragma once
 
 #include <string>
-#include <fstream>
-#include <memory>
 
 #include <QByteArray>
+#include <QFile>
 #include <QFileDialog>
 #include <QWidget>
 
+#include "ByteView.h"
+
+#define READ_AHEAD_SIZE		(1 << 20)
+#define READ_ALIGNMENT		4096
+
 using namespace std;
 
-class FileManip : public QWidget 
+struct FileChunk
+{
+	qint64 offset;
+	int length;
+};
+
+class FileManip : public QWidget
 {
 	Q_OBJECT
 
@@ -18,18 +28,45 @@ public:
 	FileManip(QObject* parent = nullptr);
 	~FileManip();
 
-	QByteArray GetNextBytes();
-	QByteArray GetPreviousBytes();
-	bool IsAtEndOfFile();
+	FileChunk GetNextChunk(const int maxLength);
+	ByteView GetChunk(const FileChunk& chunk);
+	void SetPosition(const qint64 position);
+	void Select(const QString& name);
+	void Open(const QString& name);
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetSize()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: qint64 GetSize (void)
+	--
+	-- RETURNS: The size of the selected file in bytes, or 0 if no file is open.
+	-------------------------------------------------------------------------------------------------*/
+	inline qint64 GetSize() const { return mSize; }
 
 private:
 	string mFile;
-	unique_ptr<ifstream> mInStream;
-	char mBuffer[512];
+	QFile mSource;
+	const char* mMap;
+	qint64 mSize;
+	qint64 mPosition;
+	QByteArray mBlock;
+	qint64 mBlockOffset;
+
+	void readBlock(const qint64 offset, const qint64 end);
+	void close();
 
 public slots:
 	void SelectFile();
 
 signals:
 	void fileChanged(string newFileName);
+	void fileSelected(const QString name);
 };
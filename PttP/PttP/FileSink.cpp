@@ -0,0 +1,443 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FileSink.cpp - A receive sink that saves the received file to disk.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- FileSink(const QString& fileName, QObject* parent)
+-- ~FileSink()
+-- void run()
+-- void Start(const qint64 size, const qint64 offset)
+-- void Write(const ByteView& data)
+-- void Finish()
+-- void submit(const FileSinkRequest::Type type, const qint64 offset, const QByteArray& bytes)
+-- QByteArray takeBuffer()
+-- void writeBuffer(const int length)
+-- void handleRequest(const FileSinkRequest& request)
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- The protocol thread copies the data of each frame into a large buffer. Once the buffer holds WRITE_BUFFER_SIZE
+-- bytes, everything up to the last WRITE_ALIGNMENT boundary is handed to this thread, which does the actual writing.
+-- The protocol thread never touches the file itself, so a slow disk only holds it up if WRITE_QUEUE_DEPTH buffers are
+-- already waiting to be written.
+--
+-- The file is written through a QSaveFile, so the data goes to a temporary file next to the output file. The space
+-- for the whole file is reserved as soon as the sender announces its size. When an EOT arrives after every byte of the
+-- file has been received, the temporary file replaces the output file in one rename. A transfer that never finishes
+-- leaves the output file as it was.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "FileSink.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#endif
+
+#include "FrameParser.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FileSink
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		FileSink (const QString& fileName, QObject* parent)
+--						const QString& fileName: The file to save the received file as.
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Nothing is written until the sender starts a transfer from the start of a file.
+----------------------------------------------------------------------------------------------------------------------*/
+FileSink::FileSink(const QString& fileName, QObject* parent)
+	: QThread(parent)
+	, mFile(fileName)
+	, mRunning(true)
+	, mOpen(false)
+	, mSize(0)
+	, mOffset(0)
+	, mBuffer(takeBuffer())
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~FileSink
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~FileSink (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Deconstructor. Lets the thread finish the requests that are already queued and waits for it to stop. A file that
+-- was not committed is thrown away.
+----------------------------------------------------------------------------------------------------------------------*/
+FileSink::~FileSink()
+{
+	mMutex.lock();
+	mRunning = false;
+	mWork.wakeAll();
+	mMutex.unlock();
+	wait();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: run
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void run (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Handles the queued requests in order, without holding the lock while the file is used. The buffer of every write
+-- is kept so the protocol thread can fill it again.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::run()
+{
+	mMutex.lock();
+	while (true)
+	{
+		if (mQueue.isEmpty())
+		{
+			if (!mRunning)
+			{
+				break;
+			}
+			mWork.wait(&mMutex);
+			continue;
+		}
+
+		FileSinkRequest request = mQueue.takeFirst();
+		mMutex.unlock();
+
+		handleRequest(request);
+
+		mMutex.lock();
+		if (request.type == FileSinkRequest::WRITE)
+		{
+			request.bytes.resize(0);
+			mFree.append(request.bytes);
+		}
+		mDone.wakeAll();
+	}
+	mMutex.unlock();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Start (const qint64 size, const qint64 offset)
+--						const qint64 size: The size of the file the sender is sending.
+--						const qint64 offset: The offset in the file of the data in the next frame.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called for every ENQ. A transfer that starts at the beginning of a file opens a new temporary file of the announced
+-- size, throwing away one that was not finished.
+--
+-- Otherwise the transfer carries on from offset. The sender may go back to data that was already received when an ACK
+-- was lost, so the data after offset is dropped and written again. A transfer that skips ahead or was never started
+-- cannot be saved and is ignored until the sender starts from the beginning again.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::Start(const qint64 size, const qint64 offset)
+{
+	if (offset == 0)
+	{
+		mOpen = true;
+		mSize = size;
+		mOffset = 0;
+		mBuffer.resize(0);
+		submit(FileSinkRequest::OPEN, size);
+	}
+	else if (mOpen && offset <= mOffset + mBuffer.size())
+	{
+		if (offset >= mOffset)
+		{
+			mBuffer.resize((int)(offset - mOffset));
+		}
+		else
+		{
+			mBuffer.resize(0);
+			mOffset = offset;
+		}
+	}
+	else if (mOpen)
+	{
+		qDebug() << "cannot resume receiving at" << offset << "after" << mOffset + mBuffer.size() << "bytes";
+		mOpen = false;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Write (const ByteView& data)
+--						const ByteView& data: The data of the next frame in sequence.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Copies the data onto the end of the buffer. Once the buffer is full, everything up to the last WRITE_ALIGNMENT
+-- boundary in the file is handed to the thread to write.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::Write(const ByteView& data)
+{
+	if (!mOpen)
+	{
+		return;
+	}
+
+	mBuffer.append(data.data, data.size);
+	if (mBuffer.size() >= WRITE_BUFFER_SIZE)
+	{
+		writeBuffer(mBuffer.size() - (int)((mOffset + mBuffer.size()) % WRITE_ALIGNMENT));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Finish
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Finish (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called for every EOT. The sender also sends an EOT when it hands the line over part way through the file, so the
+-- file is only committed once all of it has been received. The rest of the buffer is written and the thread renames
+-- the temporary file over the output file.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::Finish()
+{
+	if (!mOpen || mOffset + mBuffer.size() < mSize)
+	{
+		return;
+	}
+
+	if (!mBuffer.isEmpty())
+	{
+		writeBuffer(mBuffer.size());
+	}
+	submit(FileSinkRequest::COMMIT, mSize);
+	mOpen = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: submit
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void submit (const FileSinkRequest::Type type, const qint64 offset, const QByteArray& bytes)
+--						const FileSinkRequest::Type type: What the thread should do.
+--						const qint64 offset: Where to write the bytes, or the size of the file to open or commit.
+--						const QByteArray& bytes: The bytes to write.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Queues a request for the thread. If WRITE_QUEUE_DEPTH requests are already waiting, this waits for the thread to
+-- finish one so a disk that cannot keep up does not use up all the memory.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::submit(const FileSinkRequest::Type type, const qint64 offset, const QByteArray& bytes)
+{
+	QMutexLocker locker(&mMutex);
+
+	while (mQueue.size() >= WRITE_QUEUE_DEPTH && mRunning)
+	{
+		mDone.wait(&mMutex);
+	}
+
+	FileSinkRequest request;
+	request.type = type;
+	request.offset = offset;
+	request.bytes = bytes;
+	mQueue.append(request);
+	mWork.wakeAll();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: takeBuffer
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		QByteArray takeBuffer (void)
+--
+-- RETURNS:			An empty buffer.
+--
+-- NOTES:
+-- Reuses a buffer the thread has finished writing if there is one. A new buffer reserves room for a full buffer and
+-- one more frame, so filling it never reallocates.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray FileSink::takeBuffer()
+{
+	QMutexLocker locker(&mMutex);
+
+	if (!mFree.isEmpty())
+	{
+		return mFree.takeLast();
+	}
+
+	QByteArray bytes;
+	bytes.reserve(WRITE_BUFFER_SIZE + MAX_DATA_LENGTH);
+	return bytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: writeBuffer
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void writeBuffer (const int length)
+--						const int length: The number of bytes from the start of the buffer to write.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Hands the buffer itself to the thread instead of copying it. The bytes after length are moved into an empty buffer,
+-- which becomes the buffer that is filled from now on.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::writeBuffer(const int length)
+{
+	QByteArray bytes = takeBuffer();
+	bytes.append(mBuffer.constData() + length, mBuffer.size() - length);
+	mBuffer.resize(length);
+	mBuffer.swap(bytes);
+
+	submit(FileSinkRequest::WRITE, mOffset, bytes);
+	mOffset += length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: handleRequest
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void handleRequest (const FileSinkRequest& request)
+--						const FileSinkRequest& request: The request to carry out.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Runs on the thread. Opening throws away the temporary file of an unfinished transfer, opens a new one and reserves
+-- the space for the whole file so it does not have to grow while it is written. Writing puts the bytes at their offset
+-- in the file. Committing cuts the file to its size and renames it over the output file; QSaveFile does not commit a
+-- file that had a write fail, so a file with missing data is never saved.
+----------------------------------------------------------------------------------------------------------------------*/
+void FileSink::handleRequest(const FileSinkRequest& request)
+{
+	switch (request.type)
+	{
+	case FileSinkRequest::OPEN:
+		if (mFile.isOpen())
+		{
+			mFile.cancelWriting();
+			mFile.commit();
+		}
+		if (!mFile.open(QIODevice::WriteOnly))
+		{
+			qDebug() << "could not open" << mFile.fileName() << mFile.errorString();
+			break;
+		}
+#ifdef Q_OS_UNIX
+		if (request.offset > 0)
+		{
+			posix_fallocate(mFile.handle(), 0, request.offset);
+		}
+#else
+		mFile.resize(request.offset);
+#endif
+		break;
+	case FileSinkRequest::WRITE:
+		if (mFile.isOpen() && (!mFile.seek(request.offset) || mFile.write(request.bytes) != request.bytes.size()))
+		{
+			qDebug() << "could not write to" << mFile.fileName() << mFile.errorString();
+		}
+		break;
+	case FileSinkRequest::COMMIT:
+		if (mFile.isOpen())
+		{
+			mFile.resize(request.offset);
+			qDebug() << (mFile.commit() ? "saved" : "could not save") << mFile.fileName();
+		}
+		break;
+	}
+}
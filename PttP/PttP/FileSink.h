@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QSaveFile>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "ReceiveSink.h"
+
+#define RECEIVE_FILE_NAME	"received.txt"
+#define WRITE_BUFFER_SIZE	(1 << 20)
+#define WRITE_ALIGNMENT		4096
+#define WRITE_QUEUE_DEPTH	4
+
+using namespace std;
+
+struct FileSinkRequest
+{
+	enum Type
+	{
+		OPEN,
+		WRITE,
+		COMMIT
+	};
+
+	Type type;
+	qint64 offset;
+	QByteArray bytes;
+};
+
+class FileSink : public QThread, public ReceiveSink
+{
+	Q_OBJECT
+
+public:
+	FileSink(const QString& fileName, QObject* parent = nullptr);
+	~FileSink();
+
+	void Start(const qint64 size, const qint64 offset) override;
+	void Write(const ByteView& data) override;
+	void Finish() override;
+
+protected:
+	void run();
+
+private:
+	QSaveFile mFile;
+
+	QMutex mMutex;
+	QWaitCondition mWork;
+	QWaitCondition mDone;
+	bool mRunning;
+	QList<FileSinkRequest> mQueue;
+	QList<QByteArray> mFree;
+
+	bool mOpen;
+	qint64 mSize;
+	qint64 mOffset;
+	QByteArray mBuffer;
+
+	void submit(const FileSinkRequest::Type type, const qint64 offset, const QByteArray& bytes = QByteArray());
+	QByteArray takeBuffer();
+	void writeBuffer(const int length);
+	void handleRequest(const FileSinkRequest& request);
+};
@@ -0,0 +1,382 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FrameParser.cpp - Splits the bytes read from the port into frames.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- FrameParser(const int maxDataLength)
+-- int Write(const char* data, const int length)
+-- char* GetWriteSpace(int& length)
+-- void CommitWrite(const int length)
+-- bool ReadFrame(ByteView& frame)
+-- void Reject()
+-- void Clear()
+-- uint8_t at(const uint64_t index)
+-- void resync()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Received bytes are kept in a ring buffer of a fixed size. The parser remembers how far it got through the current
+-- frame, so a frame that is split over several reads is picked up where it left off and every byte is only looked at
+-- once. The data of a data frame is skipped over in one step once its length is known.
+--
+-- Bytes before a SYN are dropped. A SYN followed by an unknown type, or a data frame header with an impossible
+-- length, is treated as noise and the search for the next SYN starts from the byte after it. So is a frame the caller
+-- rejects because it fails its CRC, since a damaged length may have made it swallow the frames behind it.
+--
+-- Positions in the ring are kept as byte counts that only go up, and are wrapped into the ring when it is read.
+--
+-- A complete frame is handed back as a view into the ring, so it is not copied. Only a frame that wraps around the end
+-- of the ring is copied, into a buffer that is kept for that.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "FrameParser.h"
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FrameParser
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		FrameParser (const int maxDataLength)
+--						const int maxDataLength: The largest number of data bytes a data frame may carry.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Allocates the ring buffer, which is large enough to hold two of the largest possible data frames, and
+-- the buffer for a frame that wraps around the end of it.
+----------------------------------------------------------------------------------------------------------------------*/
+FrameParser::FrameParser(const int maxDataLength)
+	: mRing(PARSER_CAPACITY)
+	, mMaxDataLength(maxDataLength)
+{
+	mWrapped.reserve(DATA_HEADER_SIZE + MAX_DATA_LENGTH + CRC_LENGTH);
+	Clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		int Write (const char* data, const int length)
+--						const char* data: The bytes that were received.
+--						const int length: The number of bytes that were received.
+--
+-- RETURNS:			The number of bytes that were taken.
+--
+-- NOTES:
+-- Copies received bytes into the ring buffer without parsing them.
+--
+-- Only as many bytes as there is room for are taken. Reading every complete frame with ReadFrame always leaves room
+-- for at least one more full frame, so the caller can write the rest after that.
+--
+-- Writing may overwrite the bytes of frames that were already read, so any view of them is no longer valid.
+----------------------------------------------------------------------------------------------------------------------*/
+int FrameParser::Write(const char* data, const int length)
+{
+	int count = min(length, GetFreeSpace());
+	int offset = (int)(mTail % PARSER_CAPACITY);
+	int first = min(count, PARSER_CAPACITY - offset);
+
+	memcpy(mRing.data() + offset, data, first);
+	memcpy(mRing.data(), data + first, count - first);
+	mTail += count;
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: GetWriteSpace
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		char* GetWriteSpace (int& length)
+--						int& length: Set to the number of bytes that can be put at the returned pointer.
+--
+-- RETURNS:			Where the next received byte goes in the ring buffer.
+--
+-- NOTES:
+-- Lets the caller read from the port straight into the ring buffer instead of into a buffer of its own that is then
+-- copied with Write. The space ends at the end of the ring buffer, so it may be less than GetFreeSpace. The bytes
+-- only become part of the buffer once CommitWrite is called.
+----------------------------------------------------------------------------------------------------------------------*/
+char* FrameParser::GetWriteSpace(int& length)
+{
+	int offset = (int)(mTail % PARSER_CAPACITY);
+	length = min(GetFreeSpace(), PARSER_CAPACITY - offset);
+	return mRing.data() + offset;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CommitWrite
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void CommitWrite (const int length)
+--						const int length: The number of bytes that were put in the space from GetWriteSpace.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Adds bytes that were put straight into the ring buffer, the same as if they had been written with Write.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameParser::CommitWrite(const int length)
+{
+	mTail += length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ReadFrame
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Hands back a view of the frame instead of copying it.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool ReadFrame (ByteView& frame)
+--						ByteView& frame: Set to a view of the next complete frame, starting with its SYN.
+--
+-- RETURNS:			True if a complete frame was found, otherwise false.
+--
+-- NOTES:
+-- Parses the bytes that were written since the last call until a frame is complete.
+--
+-- The type byte decides how long a control frame is, and the length in the header of a data frame decides how long
+-- the rest of it is. If the bytes run out part way through a frame, false is returned and parsing carries on from the
+-- same place after the next write. The bytes of a frame are released once it has been read, unless it is then
+-- rejected with Reject.
+--
+-- The largest data frame is checked when the header of a data frame is parsed, so a change made between calls
+-- applies to every frame after the last one read.
+--
+-- The view points into the ring buffer, or into the buffer for wrapped frames, and stays valid until the next call to
+-- Write or ReadFrame.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FrameParser::ReadFrame(ByteView& frame)
+{
+	int offset;
+	int first;
+
+	while (mScan < mTail)
+	{
+		switch (mState)
+		{
+		case WAIT_SYN:
+			if (at(mScan) == SYN)
+			{
+				mFrameStart = mScan;
+				mState = WAIT_TYPE;
+			}
+			mScan++;
+			if (mState == WAIT_SYN)
+			{
+				mHead = mScan;
+			}
+			break;
+		case WAIT_TYPE:
+			switch (at(mScan))
+			{
+			case ENQ:
+				mFrameSize = ENQ_FRAME_SIZE;
+				break;
+			case ACK:
+				mFrameSize = ACK_FRAME_SIZE;
+				break;
+			case NAK:
+				mFrameSize = NAK_FRAME_SIZE;
+				break;
+			case EOT:
+			case RVI:
+				mFrameSize = CONTROL_FRAME_SIZE;
+				break;
+			case STX:
+				mFrameSize = DATA_HEADER_SIZE;
+				break;
+			default:
+				resync();
+				continue;
+			}
+			mScan++;
+			mState = at(mFrameStart + 1) == STX ? WAIT_HEADER : WAIT_BODY;
+			break;
+		case WAIT_HEADER:
+		case WAIT_BODY:
+			mScan = min(mTail, mFrameStart + mFrameSize);
+			if (mScan - mFrameStart < (uint64_t)mFrameSize)
+			{
+				return false;
+			}
+			if (mState == WAIT_HEADER)
+			{
+				int dataLength = (at(mFrameStart + 3) << 8) | at(mFrameStart + 4);
+				if (dataLength == 0 || dataLength > mMaxDataLength)
+				{
+					resync();
+					continue;
+				}
+				mFrameSize += dataLength + CRC_LENGTH;
+				mState = WAIT_BODY;
+				break;
+			}
+
+			offset = (int)(mFrameStart % PARSER_CAPACITY);
+			if (offset + mFrameSize <= PARSER_CAPACITY)
+			{
+				frame = ByteView(mRing.data() + offset, mFrameSize);
+			}
+			else
+			{
+				first = PARSER_CAPACITY - offset;
+				mWrapped.resize(mFrameSize);
+				memcpy(mWrapped.data(), mRing.data() + offset, first);
+				memcpy(mWrapped.data() + first, mRing.data(), mFrameSize - first);
+				frame = ByteView(mWrapped);
+			}
+			mHead = mScan;
+			mState = WAIT_SYN;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reject
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Reject (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called when the frame ReadFrame last handed back fails its CRC. The frame is taken to be noise and the search for
+-- the next SYN starts again from the byte after the one it started with.
+--
+-- A flipped bit in the length of a data frame makes the parser take too many or too few bytes as its body. Too many
+-- would swallow the frames behind it, and too few would start the next frame part way through its data. Either way
+-- the frames that follow are still in the ring buffer and are found by looking again.
+--
+-- Must be called before the next Write, since the bytes of the frame may be overwritten after that.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameParser::Reject()
+{
+	resync();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Clear
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Clear (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Drops every byte in the ring buffer, including any part of a frame, and starts looking for a SYN again.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameParser::Clear()
+{
+	mHead = 0;
+	mScan = 0;
+	mTail = 0;
+	mState = WAIT_SYN;
+	mFrameStart = 0;
+	mFrameSize = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: at
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		uint8_t at (const uint64_t index)
+--						const uint64_t index: The position of the byte as a count of every byte written.
+--
+-- RETURNS:			The byte at that position in the ring buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+uint8_t FrameParser::at(const uint64_t index) const
+{
+	return (uint8_t)mRing[index % PARSER_CAPACITY];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: resync
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void resync (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Gives up on the current frame and looks for the next SYN from the byte after the one the frame started with. At
+-- most the few header bytes that were already parsed are looked at again.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameParser::resync()
+{
+	mHead = mFrameStart + 1;
+	mScan = mHead;
+	mState = WAIT_SYN;
+}
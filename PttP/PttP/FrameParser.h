@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QByteArray>
+
+#include "ByteView.h"
+#include "ControlCharacters.h"
+
+#define DATA_HEADER_SIZE 5
+#define CRC_LENGTH	4
+
+#define DEFAULT_DATA_LENGTH	512
+#define MIN_DATA_LENGTH		64
+#define MAX_DATA_LENGTH		65535
+
+#define ACK_FRAME_SIZE		13
+#define ENQ_FRAME_SIZE		26
+#define NAK_FRAME_SIZE		7
+#define CONTROL_FRAME_SIZE	2
+
+#define PARSER_CAPACITY		(1 << 18)
+
+using namespace std;
+
+class FrameParser
+{
+public:
+	FrameParser(const int maxDataLength = MAX_DATA_LENGTH);
+
+	int Write(const char* data, const int length);
+	char* GetWriteSpace(int& length);
+	void CommitWrite(const int length);
+	bool ReadFrame(ByteView& frame);
+	void Reject();
+	void Clear();
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: SetMaxDataLength()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: void SetMaxDataLength (const int maxDataLength)
+	--				const int maxDataLength: The largest number of data bytes a data frame may carry.
+	--
+	-- RETURNS: void.
+	--
+	-- NOTES:
+	-- Data frames with a longer length in their header are treated as noise.
+	-------------------------------------------------------------------------------------------------*/
+	inline void SetMaxDataLength(const int maxDataLength) { mMaxDataLength = maxDataLength; }
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetFreeSpace()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetFreeSpace (void)
+	--
+	-- RETURNS: The number of bytes that can still be written.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetFreeSpace() const { return PARSER_CAPACITY - (int)(mTail - mHead); }
+
+private:
+	enum ParseState
+	{
+		WAIT_SYN,
+		WAIT_TYPE,
+		WAIT_HEADER,
+		WAIT_BODY
+	};
+
+	vector<char> mRing;
+	QByteArray mWrapped;
+	uint64_t mHead;
+	uint64_t mScan;
+	uint64_t mTail;
+	ParseState mState;
+	uint64_t mFrameStart;
+	int mFrameSize;
+	int mMaxDataLength;
+
+	uint8_t at(const uint64_t index) const;
+	void resync();
+};
@@ -0,0 +1,193 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FramePool.cpp - A fixed set of frame buffers that are borrowed and returned instead of allocated.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- FramePool()
+-- void Reset(const int count, const int bufferSize)
+-- QByteArray* Acquire()
+-- void Release(QByteArray* buffer)
+-- void grow()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 16, 2026 - Can be borrowed from and returned to on any thread.
+--            Oct 17, 2026 - Stays at the size it was reset to instead of growing when it runs dry.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Every buffer has room reserved for the largest frame, so resizing a borrowed buffer within that size never
+-- allocates and giving it back keeps the memory for the next user. The number of buffers is chosen by the owner so
+-- that every buffer that can be borrowed at once fits. The pool never grows past that, since a pool that runs dry
+-- means that count is wrong or a buffer was never given back, and growing would only hide it. A warning is logged
+-- instead and the caller is given no buffer.
+--
+-- The protocol thread borrows buffers for the receive window and for splitting frames, and the frame prefetcher
+-- borrows the buffers it builds new data frames in on its own thread, so borrowing and returning lock the pool. The
+-- counters cover both and can be read from any thread.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "FramePool.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FramePool
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		FramePool (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. The pool is empty until it is reset.
+----------------------------------------------------------------------------------------------------------------------*/
+FramePool::FramePool()
+	: mBufferSize(0)
+	, mSize(0)
+	, mInUse(0)
+	, mHighWaterMark(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reset
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Locks the pool.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Reset (const int count, const int bufferSize)
+--						const int count: The number of buffers to allocate.
+--						const int bufferSize: The number of bytes to reserve in each buffer.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Throws away every buffer and allocates a new set. No buffer may be borrowed when this is called.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePool::Reset(const int count, const int bufferSize)
+{
+	QMutexLocker locker(&mMutex);
+	mBuffers.clear();
+	mFree.clear();
+	mBufferSize = bufferSize;
+	mSize = 0;
+	mInUse = 0;
+	mHighWaterMark = 0;
+
+	mBuffers.reserve(count);
+	mFree.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		grow();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Acquire
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Locks the pool.
+--					Oct 17, 2026 - Returns nullptr instead of growing the pool when every buffer is borrowed.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		QByteArray* Acquire (void)
+--
+-- RETURNS:			An empty buffer with room for the largest frame, or nullptr if every buffer is borrowed.
+--
+-- NOTES:
+-- Borrows a buffer from the pool. It must be given back with Release. If every buffer is borrowed a warning is logged
+-- and nullptr is returned, and the caller has to do without.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray* FramePool::Acquire()
+{
+	QMutexLocker locker(&mMutex);
+	if (mFree.empty())
+	{
+		qWarning() << "frame buffer pool exhausted," << mSize.load() << "buffers borrowed";
+		return nullptr;
+	}
+
+	QByteArray* buffer = mFree.back();
+	mFree.pop_back();
+
+	if (++mInUse > mHighWaterMark)
+	{
+		mHighWaterMark = mInUse.load();
+	}
+	return buffer;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Release
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Locks the pool.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Release (QByteArray* buffer)
+--						QByteArray* buffer: A buffer that was borrowed with Acquire.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Gives a buffer back to the pool. It is emptied but keeps the memory reserved for it.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePool::Release(QByteArray* buffer)
+{
+	buffer->resize(0);
+
+	QMutexLocker locker(&mMutex);
+	mFree.push_back(buffer);
+	mInUse--;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: grow
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void grow (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Adds one buffer to the pool and reserves room for the largest frame in it.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePool::grow()
+{
+	mBuffers.push_back(unique_ptr<QByteArray>(new QByteArray()));
+	mBuffers.back()->reserve(mBufferSize);
+	mFree.push_back(mBuffers.back().get());
+	mSize++;
+}
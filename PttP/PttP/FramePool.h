@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QMutex>
+
+using namespace std;
+
+class FramePool
+{
+public:
+	FramePool();
+
+	void Reset(const int count, const int bufferSize);
+	QByteArray* Acquire();
+	void Release(QByteArray* buffer);
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetSize()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetSize (void)
+	--
+	-- RETURNS: The number of buffers the pool owns.
+	--
+	-- NOTES:
+	-- This function is thread safe.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetSize() const { return mSize; }
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetInUse()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetInUse (void)
+	--
+	-- RETURNS: The number of buffers that are currently borrowed.
+	--
+	-- NOTES:
+	-- This function is thread safe.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetInUse() const { return mInUse; }
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetHighWaterMark()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetHighWaterMark (void)
+	--
+	-- RETURNS: The largest number of buffers that were borrowed at once since the pool was reset.
+	--
+	-- NOTES:
+	-- This function is thread safe.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetHighWaterMark() const { return mHighWaterMark; }
+
+private:
+	QMutex mMutex;
+	vector<unique_ptr<QByteArray>> mBuffers;
+	vector<QByteArray*> mFree;
+	int mBufferSize;
+	atomic<int> mSize;
+	atomic<int> mInUse;
+	atomic<int> mHighWaterMark;
+
+	void grow();
+};
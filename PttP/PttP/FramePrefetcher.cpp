@@ -0,0 +1,467 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FramePrefetcher.cpp - A thread that reads the file ahead of the sender and builds its data frames.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- FramePrefetcher(FileManip* file, FramePool* pool, QObject* parent)
+-- ~FramePrefetcher()
+-- void run()
+-- TakeResult TakeFrame(const uint8_t seq, const int maxLength, PreparedFrame& frame)
+-- void Rewind()
+-- void SetFile(const QString& name)
+-- qint64 GetNextOffset()
+-- void restart(const uint8_t seq)
+-- void renumber(const uint8_t seq)
+-- void dropQueue()
+-- void notifyReady()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 16, 2026 - Borrows frame buffers from the frame pool shared with the receive window.
+--            Oct 16, 2026 - Renumbers the queue when a session starts instead of building it again.
+--            Oct 16, 2026 - Opens a newly selected file once no frame is being built.
+--            Oct 17, 2026 - Never makes the sender wait for a frame.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- The thread takes the next chunk of the file, reads it and builds a complete data frame with its CRC, and puts the
+-- frame in a queue of at most PREFETCH_DEPTH frames. The protocol thread only takes finished frames off the front of
+-- the queue, so reading the file and calculating the CRC are done while it waits for the other side. If no frame is
+-- ready the sender is told so instead of being made to wait, and frameReady is emitted once the next one is.
+--
+-- Frames are numbered in the order they are built, following the sequence number of the last frame that was taken. If
+-- the sender asks for a different sequence number, which happens when a session starts, the queued frames are
+-- renumbered in place. Only when the next frame is larger than the sender now wants is the queue thrown away and
+-- building started again from the end of the last frame that was taken.
+--
+-- The thread is the only one that reads the file, and a new file is only opened through SetFile while it is not
+-- reading. Frames are built in buffers borrowed from the frame pool, and the sender gives each one back to the pool
+-- once it has been acknowledged.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "FramePrefetcher.h"
+
+#include <QMutexLocker>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FramePrefetcher
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Borrows frame buffers from a frame pool.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		FramePrefetcher (FileManip* file, FramePool* pool, QObject* parent)
+--						FileManip* file: The file to read the frames from.
+--						FramePool* pool: The pool the frame buffers are borrowed from.
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Nothing is built until the sender asks for the first frame.
+----------------------------------------------------------------------------------------------------------------------*/
+FramePrefetcher::FramePrefetcher(FileManip* file, FramePool* pool, QObject* parent)
+	: QThread(parent)
+	, mFile(file)
+	, mPool(pool)
+	, mRunning(true)
+	, mActive(false)
+	, mEndOfFile(false)
+	, mBuilding(false)
+	, mWaiting(false)
+	, mGeneration(0)
+	, mExpectedSeq(0)
+	, mDataLength(DEFAULT_DATA_LENGTH)
+	, mTakenEnd(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~FramePrefetcher
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~FramePrefetcher (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Deconstructor. Stops the thread and waits for it to finish the frame it is building.
+----------------------------------------------------------------------------------------------------------------------*/
+FramePrefetcher::~FramePrefetcher()
+{
+	mMutex.lock();
+	mRunning = false;
+	mWork.wakeAll();
+	mReady.wakeAll();
+	mMutex.unlock();
+	wait();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: run
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Builds frames in buffers borrowed from the frame pool.
+--					Oct 16, 2026 - Renumbers a frame if the queue was renumbered while it was being built.
+--					Oct 16, 2026 - Lets SetFile know when it is done building a frame.
+--					Oct 17, 2026 - Emits frameReady when the sender asked for a frame that was not ready.
+--					Oct 17, 2026 - Waits for a buffer when the frame pool has none to lend.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void run (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Builds frames while the sender is sending, the end of the file has not been reached and the queue has room, and
+-- sleeps otherwise.
+--
+-- The chunk and its sequence number are taken while holding the lock, but the file is read and the frame is built
+-- without it so the sender can take frames in the meantime. If the queue was thrown away while the frame was being
+-- built, the frame is dropped and its buffer given back to the pool. If the queue was renumbered instead, the frame is
+-- renumbered to follow it.
+--
+-- If the sender asked for a frame while the queue was empty, frameReady is emitted once a frame is queued or the end
+-- of the file is reached, so it knows to ask again.
+--
+-- If the frame pool has no buffer to lend, the chunk is put back and the thread tries again after POOL_RETRY_TIME ms,
+-- since the pool does not say when a buffer is given back.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::run()
+{
+	mMutex.lock();
+	while (mRunning)
+	{
+		if (!mActive || mEndOfFile || mQueue.size() >= PREFETCH_DEPTH)
+		{
+			mWork.wait(&mMutex);
+			continue;
+		}
+
+		PreparedFrame prepared;
+		prepared.chunk = mFile->GetNextChunk(mDataLength);
+		if (prepared.chunk.length == 0)
+		{
+			mEndOfFile = true;
+			notifyReady();
+			continue;
+		}
+		prepared.frame = mPool->Acquire();
+		if (prepared.frame == nullptr)
+		{
+			mFile->SetPosition(prepared.chunk.offset);
+			mWork.wait(&mMutex, POOL_RETRY_TIME);
+			continue;
+		}
+		uint8_t seq = mExpectedSeq + mQueue.size();
+		uint64_t generation = mGeneration;
+		mBuilding = true;
+		mMutex.unlock();
+
+		FrameWriter::WriteDataFrame(seq, mFile->GetChunk(prepared.chunk), *prepared.frame);
+
+		mMutex.lock();
+		mBuilding = false;
+		mReady.wakeAll();
+		if (generation == mGeneration)
+		{
+			FrameWriter::Reframe(*prepared.frame, mExpectedSeq + mQueue.size(), prepared.chunk.length);
+			mQueue.append(prepared);
+			notifyReady();
+		}
+		else
+		{
+			mPool->Release(prepared.frame);
+		}
+	}
+	mMutex.unlock();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TakeFrame
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Renumbers the queued frames instead of throwing them away.
+--					Oct 17, 2026 - Says that no frame is ready instead of waiting for one.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		TakeResult TakeFrame (const uint8_t seq, const int maxLength, PreparedFrame& frame)
+--						const uint8_t seq: The sequence number the frame must have.
+--						const int maxLength: The largest number of data bytes the frame may have.
+--						PreparedFrame& frame: Set to the next frame and the chunk of the file it holds.
+--
+-- RETURNS:			FRAME_TAKEN if a frame was taken, FRAME_NOT_READY if the next one has not been built yet, or
+--					END_OF_FILE if the whole file has been taken.
+--
+-- NOTES:
+-- Takes the next finished frame off the queue. Frames built from now on hold up to maxLength data bytes.
+--
+-- If the sequence number that is asked for is not the one that follows the last frame taken, the queued frames are
+-- renumbered from it. If the next frame holds more than maxLength bytes, the queue is thrown away and the frame is
+-- built again.
+--
+-- This never waits, since it runs on the I/O thread. If no frame is ready, which only happens when the thread has
+-- fallen behind or has only just been started, FRAME_NOT_READY is returned and frameReady is emitted once there is
+-- something to take.
+----------------------------------------------------------------------------------------------------------------------*/
+FramePrefetcher::TakeResult FramePrefetcher::TakeFrame(const uint8_t seq, const int maxLength, PreparedFrame& frame)
+{
+	QMutexLocker locker(&mMutex);
+
+	mDataLength = maxLength;
+	if (!mActive)
+	{
+		restart(seq);
+	}
+	else if (mExpectedSeq != seq)
+	{
+		renumber(seq);
+	}
+
+	if (!mQueue.isEmpty() && mQueue.first().chunk.length > maxLength)
+	{
+		restart(seq);
+	}
+
+	if (mQueue.isEmpty())
+	{
+		if (mEndOfFile || !mRunning)
+		{
+			return END_OF_FILE;
+		}
+		mWaiting = true;
+		mWork.wakeAll();
+		return FRAME_NOT_READY;
+	}
+
+	frame = mQueue.takeFirst();
+	mExpectedSeq++;
+	mTakenEnd = frame.chunk.offset + frame.chunk.length;
+	mWork.wakeAll();
+	return FRAME_TAKEN;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Rewind
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Rewind (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Throws the queue away and goes back to the start of the file. Nothing is built until the sender asks for a frame
+-- again, so the file can be sent again from the start.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::Rewind()
+{
+	QMutexLocker locker(&mMutex);
+	dropQueue();
+	mTakenEnd = 0;
+	mFile->SetPosition(0);
+	mEndOfFile = false;
+	mActive = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SetFile
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void SetFile (const QString& name)
+--						const QString& name: The path of the file to send from now on.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Throws the queue away, waits for the thread to finish the frame it is building, and then opens the new file in
+-- place of the old one. The thread reads the file without holding the lock, so this is the only safe time to unmap it.
+-- Like Rewind, nothing is built until the sender asks for a frame again.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::SetFile(const QString& name)
+{
+	QMutexLocker locker(&mMutex);
+	dropQueue();
+	while (mBuilding)
+	{
+		mReady.wait(&mMutex);
+	}
+	mFile->Open(name);
+	mTakenEnd = 0;
+	mEndOfFile = false;
+	mActive = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: GetNextOffset
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 GetNextOffset (void)
+--
+-- RETURNS:			The offset in the file of the data in the next frame that will be taken.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 FramePrefetcher::GetNextOffset()
+{
+	QMutexLocker locker(&mMutex);
+	return mTakenEnd;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: restart
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void restart (const uint8_t seq)
+--						const uint8_t seq: The sequence number of the next frame to build.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Throws the queue away and starts building again from the end of the last frame that was taken. Must be called
+-- while holding the lock.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::restart(const uint8_t seq)
+{
+	dropQueue();
+	mFile->SetPosition(mTakenEnd);
+	mExpectedSeq = seq;
+	mEndOfFile = false;
+	mActive = true;
+	mWork.wakeAll();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: renumber
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void renumber (const uint8_t seq)
+--						const uint8_t seq: The sequence number the next frame taken should have.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Gives the queued frames consecutive sequence numbers starting from seq. Only the header and CRC of each frame are
+-- written again, the file is not read. Must be called while holding the lock.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::renumber(const uint8_t seq)
+{
+	for (int i = 0; i < mQueue.size(); i++)
+	{
+		FrameWriter::Reframe(*mQueue[i].frame, (uint8_t)(seq + i), mQueue[i].chunk.length);
+	}
+	mExpectedSeq = seq;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: dropQueue
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Gives the buffers back to the frame pool.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void dropQueue (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Gives the buffers of every queued frame back to the pool and empties the queue. A frame that is being built when this is
+-- called is dropped once it is done. Must be called while holding the lock.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::dropQueue()
+{
+	for (int i = 0; i < mQueue.size(); i++)
+	{
+		mPool->Release(mQueue[i].frame);
+	}
+	mQueue.clear();
+	mGeneration++;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: notifyReady
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void notifyReady (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Emits frameReady if the sender was told that no frame was ready since the last time. Must be called while holding
+-- the lock, which is let go while the signal is emitted.
+----------------------------------------------------------------------------------------------------------------------*/
+void FramePrefetcher::notifyReady()
+{
+	if (mWaiting)
+	{
+		mWaiting = false;
+		mMutex.unlock();
+		emit frameReady();
+		mMutex.lock();
+	}
+}
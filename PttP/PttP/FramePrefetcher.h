@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "FileManip.h"
+#include "FramePool.h"
+#include "FrameWriter.h"
+
+#define PREFETCH_DEPTH	16
+#define POOL_RETRY_TIME	10
+
+using namespace std;
+
+struct PreparedFrame
+{
+	FileChunk chunk;
+	QByteArray* frame;
+};
+
+class FramePrefetcher : public QThread
+{
+	Q_OBJECT
+
+public:
+	enum TakeResult
+	{
+		FRAME_TAKEN,
+		FRAME_NOT_READY,
+		END_OF_FILE
+	};
+
+	FramePrefetcher(FileManip* file, FramePool* pool, QObject* parent = nullptr);
+	~FramePrefetcher();
+
+	TakeResult TakeFrame(const uint8_t seq, const int maxLength, PreparedFrame& frame);
+	void Rewind();
+	void SetFile(const QString& name);
+	qint64 GetNextOffset();
+
+protected:
+	void run();
+
+private:
+	FileManip* mFile;
+	FramePool* mPool;
+
+	QMutex mMutex;
+	QWaitCondition mWork;
+	QWaitCondition mReady;
+
+	bool mRunning;
+	bool mActive;
+	bool mEndOfFile;
+	bool mBuilding;
+	bool mWaiting;
+	QList<PreparedFrame> mQueue;
+	uint64_t mGeneration;
+	uint8_t mExpectedSeq;
+	int mDataLength;
+	qint64 mTakenEnd;
+
+	void restart(const uint8_t seq);
+	void renumber(const uint8_t seq);
+	void dropQueue();
+	void notifyReady();
+
+signals:
+	void frameReady();
+};
@@ -0,0 +1,373 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FrameWriter.cpp - Builds outgoing frames in a buffer that is reused for every frame.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- FrameWriter()
+-- void WriteDataFrame(const uint8_t seq, const ByteView& data, QByteArray& frame)
+-- void Reframe(QByteArray& frame, const uint8_t seq, const int dataLength)
+-- const QByteArray& WriteACK(const uint8_t seq, const uint16_t dataLength, const uint32_t received)
+-- const QByteArray& WriteENQ(const uint16_t maxDataLength, const uint64_t fileSize, const uint64_t offset,
+--		const uint16_t timeout)
+-- const QByteArray& WriteNAK(const uint8_t seq)
+-- char* begin(QByteArray& frame, const int size, const char type)
+-- void seal(QByteArray& frame, char* out)
+-- char* put(char* out, const uint16_t value)
+-- char* put(char* out, const uint32_t value)
+-- char* put(char* out, const uint64_t value)
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 16, 2026 - Data frames are written into a buffer given by the caller.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Every control frame is written straight into one buffer that is allocated up front. Numbers are written big endian
+-- and the CRC of a frame is calculated over the bytes already in the buffer, so building a frame does not allocate.
+--
+-- ACK, NAK and ENQ frames end with a CRC-32 of their type and fields, the same CRC that data frames use, so a bit
+-- error cannot move the send window or change the frame size.
+--
+-- The control frame that is returned is only valid until the next frame is written. It must be written to the port or
+-- copied before then. Data frames are kept until they are acknowledged, so they are written into a buffer that
+-- belongs to the caller and can be written from any thread.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "FrameWriter.h"
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FrameWriter
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - The ENQ is now the largest control frame.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		FrameWriter (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Allocates the buffer for the largest control frame.
+----------------------------------------------------------------------------------------------------------------------*/
+FrameWriter::FrameWriter()
+{
+	mFrame.reserve(ENQ_FRAME_SIZE);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteDataFrame
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Sends only the data instead of padding it with zeros.
+--					Oct 16, 2026 - Takes a view of the data so it can be copied straight out of the file.
+--					Oct 16, 2026 - Writes into a buffer given by the caller.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void WriteDataFrame (const uint8_t seq, const ByteView& data, QByteArray& frame)
+--						const uint8_t seq: The sequence number of the frame.
+--						const ByteView& data: The data to wrap in a frame. It must not point into the frame buffer.
+--						QByteArray& frame: Set to the data frame.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Writes a data frame: SYN, STX, the sequence number, the length of the data as a 16 bit big endian number, the data,
+-- and the CRC-32 of everything after the STX. The length tells the other side where the data ends, so a short frame
+-- is only as long as its data.
+--
+-- A buffer that already has room for the frame is not reallocated, so buffers can be reused for later frames.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameWriter::WriteDataFrame(const uint8_t seq, const ByteView& data, QByteArray& frame)
+{
+	char* out = begin(frame, DATA_HEADER_SIZE + data.size + CRC_LENGTH, STX);
+
+	*out++ = (char)seq;
+	out = put(out, (uint16_t)data.size);
+	memcpy(out, data.data, data.size);
+	out += data.size;
+
+	const char* crcStart = frame.constData() + 2;
+	put(out, (uint32_t)CRC::CalculateCRC32(crcStart, out - crcStart));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reframe
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Reframe (QByteArray& frame, const uint8_t seq, const int dataLength)
+--						QByteArray& frame: A data frame written by WriteDataFrame.
+--						const uint8_t seq: The sequence number the frame should have.
+--						const int dataLength: The number of data bytes to keep, no more than the frame has.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Changes the sequence number of a data frame and cuts its data short in place, then writes the new length and CRC.
+-- A frame that already has that sequence number and length is left alone, so the CRC is only calculated again when
+-- something changed.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameWriter::Reframe(QByteArray& frame, const uint8_t seq, const int dataLength)
+{
+	if ((uint8_t)frame[2] == seq && frame.size() == DATA_HEADER_SIZE + dataLength + CRC_LENGTH)
+	{
+		return;
+	}
+
+	frame.resize(DATA_HEADER_SIZE + dataLength + CRC_LENGTH);
+	char* out = frame.data() + 2;
+	*out++ = (char)seq;
+	put(out, (uint16_t)dataLength);
+
+	out = frame.data() + DATA_HEADER_SIZE + dataLength;
+	const char* crcStart = frame.constData() + 2;
+	put(out, (uint32_t)CRC::CalculateCRC32(crcStart, out - crcStart));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteACK
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		const QByteArray& WriteACK (const uint8_t seq, const uint16_t dataLength, const uint32_t received)
+--						const uint8_t seq: The sequence number of the next frame that is expected.
+--						const uint16_t dataLength: The number of data bytes per frame that was agreed on.
+--						const uint32_t received: Bit i is set if frame seq + 1 + i has already been received.
+--
+-- RETURNS:			The ACK frame.
+----------------------------------------------------------------------------------------------------------------------*/
+const QByteArray& FrameWriter::WriteACK(const uint8_t seq, const uint16_t dataLength, const uint32_t received)
+{
+	char* out = begin(mFrame, ACK_FRAME_SIZE, ACK);
+
+	*out++ = (char)seq;
+	out = put(out, dataLength);
+	out = put(out, received);
+	seal(mFrame, out);
+
+	return mFrame;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteENQ
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Announces the size of the file and where the session starts in it.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		const QByteArray& WriteENQ (const uint16_t maxDataLength, const uint64_t fileSize,
+--							const uint64_t offset, const uint16_t timeout)
+--						const uint16_t maxDataLength: The largest number of data bytes per frame this side wants to use.
+--						const uint64_t fileSize: The size of the file being sent.
+--						const uint64_t offset: The offset in the file of the data in the first frame of the session.
+--						const uint16_t timeout: How long this side waits for an ACK before resending, in ms.
+--
+-- RETURNS:			The ENQ frame.
+----------------------------------------------------------------------------------------------------------------------*/
+const QByteArray& FrameWriter::WriteENQ(const uint16_t maxDataLength, const uint64_t fileSize, const uint64_t offset,
+	const uint16_t timeout)
+{
+	char* out = begin(mFrame, ENQ_FRAME_SIZE, ENQ);
+
+	out = put(out, maxDataLength);
+	out = put(out, fileSize);
+	out = put(out, offset);
+	out = put(out, timeout);
+	seal(mFrame, out);
+
+	return mFrame;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteNAK
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		const QByteArray& WriteNAK (const uint8_t seq)
+--						const uint8_t seq: The sequence number in the header of the frame that failed its check.
+--
+-- RETURNS:			The NAK frame.
+----------------------------------------------------------------------------------------------------------------------*/
+const QByteArray& FrameWriter::WriteNAK(const uint8_t seq)
+{
+	char* out = begin(mFrame, NAK_FRAME_SIZE, NAK);
+
+	*out++ = (char)seq;
+	seal(mFrame, out);
+
+	return mFrame;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: begin
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Takes the buffer to write to.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		char* begin (QByteArray& frame, const int size, const char type)
+--						QByteArray& frame: The buffer to write the frame to.
+--						const int size: The size of the whole frame.
+--						const char type: The control character that follows the SYN.
+--
+-- RETURNS:			A pointer to the byte after the type.
+--
+-- NOTES:
+-- Sizes the buffer for a new frame and writes the SYN and the type. Sizing within the reserved space does not
+-- allocate.
+----------------------------------------------------------------------------------------------------------------------*/
+char* FrameWriter::begin(QByteArray& frame, const int size, const char type)
+{
+	frame.resize(size);
+	char* out = frame.data();
+	out[0] = SYN;
+	out[1] = type;
+	return out + 2;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: seal
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Takes the buffer to write to.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void seal (QByteArray& frame, char* out)
+--						QByteArray& frame: The control frame being written.
+--						char* out: Where the CRC goes, right after the last field.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Writes the CRC-32 of everything after the SYN, from the type up to out.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameWriter::seal(QByteArray& frame, char* out)
+{
+	const char* crcStart = frame.constData() + 1;
+	put(out, (uint32_t)CRC::CalculateCRC32(crcStart, out - crcStart));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: put
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		char* put (char* out, const uint16_t value)
+--						char* out: Where to write the number.
+--						const uint16_t value: The number to write.
+--
+-- RETURNS:			A pointer to the byte after the number.
+--
+-- NOTES:
+-- Writes a 16 bit number big endian.
+----------------------------------------------------------------------------------------------------------------------*/
+char* FrameWriter::put(char* out, const uint16_t value)
+{
+	out[0] = (char)(value >> 8);
+	out[1] = (char)value;
+	return out + 2;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: put
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		char* put (char* out, const uint32_t value)
+--						char* out: Where to write the number.
+--						const uint32_t value: The number to write.
+--
+-- RETURNS:			A pointer to the byte after the number.
+--
+-- NOTES:
+-- Writes a 32 bit number big endian.
+----------------------------------------------------------------------------------------------------------------------*/
+char* FrameWriter::put(char* out, const uint32_t value)
+{
+	out[0] = (char)(value >> 24);
+	out[1] = (char)(value >> 16);
+	out[2] = (char)(value >> 8);
+	out[3] = (char)value;
+	return out + 4;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: put
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		char* put (char* out, const uint64_t value)
+--						char* out: Where to write the number.
+--						const uint64_t value: The number to write.
+--
+-- RETURNS:			A pointer to the byte after the number.
+--
+-- NOTES:
+-- Writes a 64 bit number big endian.
+----------------------------------------------------------------------------------------------------------------------*/
+char* FrameWriter::put(char* out, const uint64_t value)
+{
+	out = put(out, (uint32_t)(value >> 32));
+	return put(out, (uint32_t)value);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include <QByteArray>
+
+#include "CRC.h"
+
+#include "ByteView.h"
+#include "ControlCharacters.h"
+#include "FrameParser.h"
+
+class FrameWriter
+{
+public:
+	FrameWriter();
+
+	static void WriteDataFrame(const uint8_t seq, const ByteView& data, QByteArray& frame);
+	static void Reframe(QByteArray& frame, const uint8_t seq, const int dataLength);
+
+	const QByteArray& WriteACK(const uint8_t seq, const uint16_t dataLength, const uint32_t received);
+	const QByteArray& WriteENQ(const uint16_t maxDataLength, const uint64_t fileSize, const uint64_t offset,
+		const uint16_t timeout);
+	const QByteArray& WriteNAK(const uint8_t seq);
+
+private:
+	QByteArray mFrame;
+
+	static char* begin(QByteArray& frame, const int size, const char type);
+	static void seal(QByteArray& frame, char* out);
+	static char* put(char* out, const uint16_t value);
+	static char* put(char* out, const uint32_t value);
+	static char* put(char* out, const uint64_t value);
+};
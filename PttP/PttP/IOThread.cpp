@@ -7,35 +7,57 @@
 -- IOThread()
 -- ~IOThread()
 -- void run()
+-- void AddReceiveSink(ReceiveSink* sink)
 -- 
 -- void setFlag(const uint32_t flag, const bool state)
+-- void updateFlags(const uint32_t set, const uint32_t clear)
 -- bool isFlagSet(const uint32_t flag)
+-- uint32_t getFlags()
 --
--- void startTimeout(const int ms)
+-- void postEvent()
+-- void handleEvents()
+-- void processState()
+--
+-- void startTimeout(const int ms, const bool addJitter)
 -- void updateTimeout()
 --
 -- void sendACK()
 -- void sendENQ()
 -- void sendEOT()
 -- void sendRVI()
+-- void sendNAK(const uint8_t seq)
 -- void sendFrame()
 -- void resendFrame()
 -- void resetFlags()
 -- void resetFlagsNoTimeout()
 -- void backoff()
--- QByteArray makeFrame(const QByteArray& data)
+-- void recordFrameOutcome(const int dataLength, const bool lost)
+-- void adaptDataLength()
 --
 -- void handleBuffer()
--- void checkPotentialDataFrame()
---
--- bool isDataFrameValid(const QByteArray& frame)
--- QString getDataFromFrame(const QByteArray& frame)
+-- void handleACK(const uint8_t seq, const uint16_t dataLength, const uint32_t received)
+-- void handleNAK(const uint8_t seq)
+-- void checkPotentialDataFrame(const ByteView& dataFrame)
+--
+-- bool isDataFrameValid(const ByteView& frame)
+-- bool isControlFrameValid(const ByteView& frame)
+-- int getReceiveTimeout()
+-- void getDataFromFrame(const ByteView& frame, QByteArray& data)
+-- void deliverFrame(const ByteView& data)
+-- void flushReceiveSinks()
+-- void releaseRxWindow()
+-- qint64 getInt64(const ByteView& frame, const int pos)
 --
 -- void SetRVI()
 -- void SendFile()
 -- void GetDataFromPort()
 -- void SetPort()
+-- void OpenPort(const QString& name)
+-- void openPort(const QString& name)
+-- void createPort(const QString& name)
+-- void openFile(const QString& name)
 -- void writeToPort(const QByteArray& frame)
+-- void drainWriteQueue()
 --
 -- DATE: Nov 29, 2017
 --
@@ -49,9 +71,37 @@
 -- This class handles all IO of the program.
 -- The task performed by this program depends on the state that it is in. The states of the program are determined by
 -- a set of bit flags. The task that are performed as specificed by the Power to the Protocoleriat protocol.
+--
+-- Data frames carry a sequence number and are sent using Go-Back-N. Up to a window of frames may be outstanding at
+-- once, the receiver acknowledges them cumulatively, and a timeout resends everything from the oldest unacknowledged
+-- frame.
+--
+-- The number of data bytes in a frame is agreed on for every session. The ENQ frame carries the largest size the
+-- sender would like to use, the receiver lowers it to what it accepts, and every ACK carries the agreed size back.
+-- Below that limit the sender picks the size of each frame from the error rate it has seen recently, and the size is
+-- written in the header of every data frame.
+--
+-- In selective repeat mode each ACK also carries a bitmap of the frames after the next expected one that have already
+-- arrived, and a timeout only resends the frames that are missing. The receiver always keeps frames that arrive out of
+-- order so it works with either mode.
+--
+-- A data frame that fails its CRC check is answered with a NAK straight away, and the sender resends the frame as
+-- soon as the NAK arrives instead of waiting for its timeout.
+--
+-- Timeouts follow the round trip times that are measured on the link. The sender times the gap between sending a frame
+-- and the ACK that first covers it, skipping frames that were resent, and the receiver times the gap between its ACK
+-- and the next valid data frame.
+--
+-- The flags are a single atomic word so the GUI slots and the protocol thread can change them without a lock. Changes
+-- that touch more than one flag are made in one step so the other thread never sees half of a state change.
+--
+-- The thread sleeps until something happens. Bytes from the port, the GUI slots and the expiry of the current timeout
+-- all wake it up, at which point the state machine is run until the flags stop changing.
 ----------------------------------------------------------------------------------------------------------------------*/
 #include "IOThread.h"
 
+#include <cstring>
+
 #include <QDebug>
 
 const QByteArray IOThread::SYN_BYTE = QByteArray(1, SYN);
@@ -60,20 +110,31 @@ const QByteArray IOThread::ACK_FRAME = SYN_BYTE + QByteArray(1, ACK);
 const QByteArray IOThread::ENQ_FRAME = SYN_BYTE + QByteArray(1, ENQ);
 const QByteArray IOThread::EOT_FRAME = SYN_BYTE + QByteArray(1, EOT);
 const QByteArray IOThread::RVI_FRAME = SYN_BYTE + QByteArray(1, RVI);
+const QByteArray IOThread::NAK_FRAME = SYN_BYTE + QByteArray(1, NAK);
 
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: IOThread
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Allocates the frame buffer pool.
+--					Oct 16, 2026 - Sends received data to the display through a receive sink.
+--					Oct 16, 2026 - Only sizes the frame buffer pool for the receive window.
+--					Oct 16, 2026 - Creates and starts the frame prefetcher, which shares the frame buffer pool.
+--					Oct 16, 2026 - Leaves creating the serial port to the I/O thread.
+--					Oct 16, 2026 - Reserves room for the write queue.
+--					Oct 16, 2026 - Takes port and file selections through an object that belongs to the I/O thread.
+--					Oct 17, 2026 - Runs the state machine again when the frame prefetcher has a frame ready.
 --
 -- DESIGNER:		Benny Wang
 --
 -- PROGRAMMER:		Benny Wang
 --
--- INTERFACE:		IOThread (QObject* parent)
+-- INTERFACE:		IOThread (QObject* parent, const int windowSize, const ArqMode arqMode)
 --						QObject* parent: The parent QObject.
+--						const int windowSize: The number of data frames that may be unacknowledged at once.
+--						const ArqMode arqMode: Whether a timeout resends the whole window or only missing frames.
+--						const int maxDataLength: The largest number of data bytes per frame this side will use.
 --
 -- RETURNS:			void.
 --
@@ -81,29 +142,70 @@ const QByteArray IOThread::RVI_FRAME = SYN_BYTE + QByteArray(1, RVI);
 -- Constructor for IOThread.
 --
 -- Sets all flags and buffers to their default state.
--- Creates all Qt signal slot connetions that are required.
+--
+-- The serial port is not created here, since it would then belong to the GUI thread. It is created by run() on the
+-- I/O thread, along with the connections it needs.
+--
+-- The frame buffer pool gets enough buffers of the largest frame size for a full receive window, a send window where
+-- every frame was split and a full prefetch queue, so a transfer does not allocate per frame. The frames to send are
+-- built ahead of time by the frame prefetcher in buffers borrowed from the same pool, and it is started here.
+--
+-- A port or file selected on another thread is handed to the I/O thread through a queued connection to an object that
+-- belongs to it. The connections are made here rather than in run(), so one selected before the thread has started
+-- is not lost but waits until its event loop runs. The frame prefetcher's frameReady signal reaches the I/O thread
+-- the same way.
 ----------------------------------------------------------------------------------------------------------------------*/
-IOThread::IOThread(QObject *parent)
+IOThread::IOThread(QObject *parent, const int windowSize, const ArqMode arqMode, const int maxDataLength)
 	: QThread(parent)
 	, mRunning(true)
 	, mFlags(0)
-	, mPort(new QSerialPort(this))
+	, mPort(nullptr)
+	, mTimer(nullptr)
 	, mFile(new FileManip(this))
+	, mPrefetcher(new FramePrefetcher(mFile, &mFramePool, this))
+	, mEventPending(false)
+	, mTxQueueHead(0)
+	, mWriteQueueDepth(0)
 	, mTxFrameCount(0)
 	, mRTXCount(0)
+	, mWindowSize(qBound(1, windowSize, MAX_WINDOW_SIZE))
+	, mArqMode(arqMode)
+	, mMaxDataLength(qBound(MIN_DATA_LENGTH, maxDataLength, MAX_DATA_LENGTH))
+	, mTxDataLimit(mMaxDataLength)
+	, mTxDataLength(mMaxDataLength)
+	, mRxDataLength(mMaxDataLength)
+	, mTxLostFrames(0)
+	, mTxBytesSent(0)
+	, mTxBase(0)
+	, mTxSent(0)
+	, mTxAcked(0)
+	, mTxEndOfFile(false)
+	, mTxEnqSentAt(-1)
+	, mTxRtt(TIMEOUT_LEN)
+	, mRxExpectedSeq(0)
+	, mRxReceived(0)
+	, mRxWindow()
+	, mRxAckSentAt(-1)
+	, mRxRtt(TIMEOUT_LEN)
+	, mRxPeerTimeout(TIMEOUT_LEN)
 	, byteError(0)
 	, byteValid(1)
+	, mTimeout(0)
 {
-	mPort->setBaudRate(QSerialPort::Baud9600);
-	mPort->setDataBits(QSerialPort::Data8);
-	mPort->setParity(QSerialPort::NoParity);
-	mPort->setStopBits(QSerialPort::OneStop);
-	mPort->setFlowControl(QSerialPort::NoFlowControl);
+	mClock.start();
 
-	connect(mPort, &QSerialPort::readyRead, this, &IOThread::GetDataFromPort, Qt::QueuedConnection);
-	connect(this, &IOThread::writeToPortSignal, this, &IOThread::writeToPort, Qt::QueuedConnection);
+	mTxQueue.reserve(WRITE_AHEAD_SIZE);
+	mParser.SetMaxDataLength(mMaxDataLength);
+	mFramePool.Reset(FRAME_POOL_SIZE, DATA_HEADER_SIZE + mMaxDataLength + CRC_LENGTH);
+	mRxSinks.append(&mDisplaySink);
+	mPrefetcher->start();
 
-	mBuffer = QByteArray();
+	mRequests.moveToThread(this);
+	connect(this, &IOThread::portSelected, &mRequests, [this](const QString& name) { openPort(name); },
+		Qt::QueuedConnection);
+	connect(mFile, &FileManip::fileSelected, &mRequests, [this](const QString& name) { openFile(name); },
+		Qt::QueuedConnection);
+	connect(mPrefetcher, &FramePrefetcher::frameReady, &mRequests, [this] { handleEvents(); }, Qt::QueuedConnection);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -111,7 +213,8 @@ IOThread::IOThread(QObject *parent)
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Stops the frame prefetcher before the file it reads is deleted.
+--					Oct 16, 2026 - The serial port is closed by the thread as it stops.
 --
 -- DESIGNER:		Benny Wang
 --
@@ -124,19 +227,47 @@ IOThread::IOThread(QObject *parent)
 -- NOTES:
 -- Deconstructor for IOThread.
 --
--- Stops the running loop, closes the serial port, and waits for the thread to stop. If the thread doesn't stop the
+-- Stops the event loop and waits for the thread to stop, which closes the serial port. If the thread doesn't stop the
 -- deconstructor will forcefully terminate it.
+--
+-- The frame prefetcher is deleted here rather than with the other children, since it would otherwise still be running
+-- when the file manipulator it reads from is deleted.
 ----------------------------------------------------------------------------------------------------------------------*/
 IOThread::~IOThread()
 {
 	mRunning = false;
-	mPort->close();
 	quit();
 	if (!wait(3000))
 	{
 		terminate();
 		wait();
 	}
+	delete mPrefetcher;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AddReceiveSink
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void AddReceiveSink(ReceiveSink* sink)
+--						ReceiveSink* sink: The sink to give received data to. It is not owned by the thread.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Adds a sink that is given the data of every frame that is received in sequence. The sink is called from the
+-- protocol thread, so it must be added before the thread is started and must outlive it.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::AddReceiveSink(ReceiveSink* sink)
+{
+	mRxSinks.append(sink);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -144,7 +275,8 @@ IOThread::~IOThread()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Forgets the round trip times measured on the previous port.
+--					Oct 16, 2026 - Hands the port name to the I/O thread instead of opening the port itself.
 --
 -- DESIGNER:		Benny Wan
 --
@@ -157,14 +289,156 @@ IOThread::~IOThread()
 -- NOTES:
 -- This is a Qt slot.
 --
--- When a port is selected, this function will get the text of the calling QAction which is the name of the port. It
--- then opens the port with that name for read and write after closing the previously open port.
+-- When a port is selected, this function will get the text of the calling QAction which is the name of the port. The
+-- port belongs to the I/O thread, so the name is passed to it and the port is opened there.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::SetPort()
 {
-	mPort->close();
-	mPort->setPortName(((QAction*)QObject::sender())->text());
-	mPort->open(QSerialPort::ReadWrite);
+	OpenPort(((QAction*)QObject::sender())->text());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: OpenPort
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void OpenPort(const QString& name)
+--						const QString& name: The name of the port to open.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Can be called from any thread. Hands the port name to the I/O thread, which opens the port, for a program that
+-- chooses its port without the port menu.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::OpenPort(const QString& name)
+{
+	emit portSelected(name);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: openPort
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Makes a new transport for the port, which need not be a serial port.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void openPort(const QString& name)
+--						const QString& name: The name of the port to open.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Runs on the I/O thread. Opens the port with the given name for read and write after closing the previously open
+-- port. Anything still waiting to be written to the old port is dropped. The round trip estimates start over because
+-- they belong to the old link.
+--
+-- The name may also be one of the names that Transport::Create takes for a link that is not a serial port, so a new
+-- transport is made for every port that is opened.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::openPort(const QString& name)
+{
+	createPort(name);
+	mTxQueue.resize(0);
+	mTxQueueHead = 0;
+	mWriteQueueDepth = 0;
+	mTxRtt.Reset();
+	mRxRtt.Reset();
+	mRxPeerTimeout = TIMEOUT_LEN;
+	if (!mPort->Open(name))
+	{
+		qDebug() << "could not open" << name << mPort->ErrorString();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: createPort
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void createPort(const QString& name)
+--						const QString& name: The name of the port the transport will open.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Runs on the I/O thread. Closes and deletes the current transport, if there is one, and makes the one for the
+-- given name without opening it. Received bytes are read from it as they arrive, and the write queue is drained into
+-- it each time it has written some.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::createPort(const QString& name)
+{
+	if (mPort != nullptr)
+	{
+		mPort->Close();
+		delete mPort;
+	}
+
+	mPort = Transport::Create(name);
+	connect(mPort, &Transport::readyRead, mPort, [this] { GetDataFromPort(); });
+	connect(mPort, &Transport::bytesWritten, mPort, [this] { drainWriteQueue(); });
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: openFile
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Emits FileOpened once the file is ready to be sent.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void openFile(const QString& name)
+--						const QString& name: The path of the file that was selected.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Runs on the I/O thread. Makes the selected file the one to send. The frames in the send window belong to the old
+-- file, so they are thrown away and their buffers given back to the pool, and the frame prefetcher opens the new file
+-- and starts again from its beginning.
+--
+-- If a session is sending the old file, it is ended with an EOT. RTS is kept, so the new file is sent next.
+--
+-- FileOpened is emitted with the size of the new file once it is ready to be sent.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::openFile(const QString& name)
+{
+	if (isFlagSet(SENT_ENQ))
+	{
+		qDebug() << "file changed while sending, sending eot";
+		sendEOT();
+	}
+
+	for (int i = 0; i < mTxWindow.size(); i++)
+	{
+		mFramePool.Release(mTxWindow[i].frame);
+	}
+	mTxWindow.clear();
+	mTxSentAt.clear();
+	mTxSent = 0;
+	mTxAcked = 0;
+	mTxEndOfFile = false;
+	mPrefetcher->SetFile(name);
+	emit FileOpened(mFile->GetSize());
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -172,7 +446,7 @@ void IOThread::SetPort()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Uses an atomic operation instead of locking a mutex.
 --
 -- DESIGNER:		Benny Wang
 --
@@ -191,16 +465,43 @@ void IOThread::SetPort()
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::setFlag(const uint32_t flag, const bool state)
 {
-	mMutex.lock();
 	if (state)
 	{
-		mFlags |= flag;
+		mFlags.fetch_or(flag);
 	}
 	else
 	{
-		mFlags &= ~flag;
+		mFlags.fetch_and(~flag);
 	}
-	mMutex.unlock();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: updateFlags
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void updateFlags(const uint32_t set, const uint32_t clear)	
+--						const uint32_t set: The flags to turn on.
+--						const uint32_t clear: The flags to turn off.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Turns one group of flags on and another off in a single step, so no other thread can see the flags part way
+-- through the change or change a flag in between.
+--
+-- This function is thread safe.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::updateFlags(const uint32_t set, const uint32_t clear)
+{
+	uint32_t flags = mFlags.load();
+	while (!mFlags.compare_exchange_weak(flags, (flags & ~clear) | set));
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -208,7 +509,7 @@ void IOThread::setFlag(const uint32_t flag, const bool state)
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Reads the atomic flags instead of locking a mutex.
 --
 -- DESIGNER:		Benny Wang
 --
@@ -226,11 +527,110 @@ void IOThread::setFlag(const uint32_t flag, const bool state)
 ----------------------------------------------------------------------------------------------------------------------*/
 bool IOThread::isFlagSet(const uint32_t flag)
 {
-	bool result;
-	mMutex.lock();
-	result = mFlags & flag;
-	mMutex.unlock();
-	return result;
+	return (mFlags.load() & flag) != 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: getFlags
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		uint32_t getFlags()	
+--
+-- RETURNS:			A snapshot of every flag.
+--
+-- NOTES:
+-- Used by the run loop to tell whether a pass through the state machine changed anything.
+--
+-- This function is thread safe.
+----------------------------------------------------------------------------------------------------------------------*/
+uint32_t IOThread::getFlags()
+{
+	return mFlags.load();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: postEvent
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Queues a call on the I/O thread's event loop instead of waking a wait condition.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void postEvent()	
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Wakes up the protocol thread so that it handles whatever just changed.
+--
+-- Only one call is queued at a time. The pending flag is cleared just before the flags are handled, so an event posted
+-- while the thread is busy queues another call and is not lost.
+--
+-- This function is thread safe.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::postEvent()
+{
+	if (!mEventPending.exchange(true))
+	{
+		emit eventPosted();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: handleEvents
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void handleEvents()	
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Runs on the I/O thread whenever bytes arrive, an event is posted or the timer fires. Runs the state machine until
+-- the flags stop changing. Every frame that was queued is then written to the port.
+--
+-- The timer is then set to fire when the current timeout ends, so the thread sleeps in its event loop until something
+-- happens. It is stopped if no timeout is running.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::handleEvents()
+{
+	uint32_t previousFlags;
+
+	mEventPending = false;
+
+	do
+	{
+		previousFlags = getFlags();
+		updateTimeout();
+		processState();
+	} while (mRunning && getFlags() != previousFlags);
+
+	drainWriteQueue();
+
+	if (isFlagSet(TOR))
+	{
+		mTimer->start((int)qMax((qint64)1, mTimeout - mClock.elapsed()));
+	}
+	else
+	{
+		mTimer->stop();
+	}
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -238,14 +638,15 @@ bool IOThread::isFlagSet(const uint32_t flag)
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - The random ms can be left out for timeouts that come from round trip estimates.
 --
 -- DESIGNER:		Benny Wang
 --
 -- PROGRAMMER:		Benny Wang
 --
--- INTERFACE:		void startTimeout(const int ms)	
+-- INTERFACE:		void startTimeout(const int ms, const bool addJitter)	
 --						const int ms: The length of the timeout in milliseconds.
+--						const bool addJitter: Whether a random ms is added to the timeout.
 --
 -- RETURNS:			void.
 --
@@ -254,11 +655,14 @@ bool IOThread::isFlagSet(const uint32_t flag)
 --
 -- Sets the timer and turns the TOR flag to true.
 -- The timer is the current time plus the given ms plus a random ms.
--- The random ms is calculated with X * 100, where X is a random number between 0 and 9 inclusive.
+-- The random ms is calculated with X * 100, where X is a random number between 0 and 9 inclusive. It keeps both sides
+-- from timing out together when they contend for the line, which a retransmission timeout does not need.
+--
+-- The I/O thread sets its timer to the end of the timeout once it is done handling the current event.
 ----------------------------------------------------------------------------------------------------------------------*/
-void IOThread::startTimeout(const int ms)
+void IOThread::startTimeout(const int ms, const bool addJitter)
 {
-	mTimeout = QTime::currentTime().addMSecs(ms).addMSecs((qrand() % 10) * 100);
+	mTimeout = mClock.elapsed() + ms + (addJitter ? (qrand() % 10) * 100 : 0);
 	setFlag(TOR, true);
 }
 
@@ -286,7 +690,7 @@ void IOThread::updateTimeout()
 {
 	if (isFlagSet(TOR))
 	{
-		if (QTime::currentTime() > mTimeout)
+		if (mClock.elapsed() >= mTimeout)
 		{
 			qDebug() << "turning timeout off";
 			setFlag(TOR, false);
@@ -312,12 +716,13 @@ void IOThread::updateTimeout()
 -- NOTES:
 -- This is Qt slot.
 --
--- When the user wants to send a file, this function sets the RTS flag to true.
+-- When the user wants to send a file, this function sets the RTS flag to true and wakes up the protocol thread.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::SendFile()
 {
 	qDebug() << "turning rts on to send file";
 	setFlag(RTS, true);
+	postEvent();
 }
 
 
@@ -339,12 +744,13 @@ void IOThread::SendFile()
 -- NOTES:
 -- This is Qt slot.
 --
--- Set the RVI flag to true.
+-- Set the RVI flag to true and wakes up the protocol thread.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::SetRVI()
 {
 	qDebug() << "setting rvi flag";
 	setFlag(SEND_RVI, true);
+	postEvent();
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -352,7 +758,15 @@ void IOThread::SetRVI()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Fills a Go-Back-N send window instead of sending a single frame.
+--					Oct 16, 2026 - Records when each frame was sent and waits for the measured timeout.
+--					Oct 16, 2026 - Reads the data into buffers borrowed from the frame buffer pool.
+--					Oct 16, 2026 - Sends frames without padding and stops at a read that comes back empty.
+--					Oct 16, 2026 - Keeps the offset and length of each frame and sends a view of the mapped file.
+--					Oct 16, 2026 - Takes finished frames from the frame prefetcher and keeps them for resending.
+--					Oct 16, 2026 - Borrows the buffer for the tail of a split frame from the frame buffer pool.
+--					Oct 17, 2026 - Does not wait for the frame prefetcher when it has no frame ready.
+--					Oct 17, 2026 - Sends a frame whole when the frame buffer pool has no buffer to split it into.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -363,40 +777,104 @@ void IOThread::SetRVI()
 -- RETURNS:			void.
 --
 -- NOTES:
--- This function handles the transmission of a frame.
+-- This function handles the transmission of frames.
+--
+-- Frames that are in the window but have not been sent this session are sent first. They are split if the size that
+-- was agreed on for this session is smaller than the one they were read with. After that, new data is read and sent
+-- until the window is full, the end of the file is reached or the transmission session hits its cap. Every frame sent
+-- counts towards the cap.
 --
--- If there is data to send and the transmission session has not hit the cap a data frame is sent and the data frame
--- sent counter is incremented by 1 and the related flags are changed. If there is no data to send or if transmission
--- cap has been hit, the EOT frame is sent and a timer is set to force a back off session so the other side has a 
--- chance to transmit.
+-- Once every frame in the window has been acknowledged and there is no more data to send, or the cap has been hit,
+-- the EOT frame is sent and a timer is set to force a back off session so the other side has a chance to transmit.
+--
+-- The time each new frame is sent is kept for the round trip estimate. Frames left over from a previous session have
+-- been sent before, so an ACK for them cannot be timed.
+--
+-- New frames are taken finished, CRC and all, from the frame prefetcher, which reads and builds them on its own thread
+-- while this one waits for ACKs. The window keeps each frame so a retransmission writes the same bytes again. A frame
+-- left over from a previous session is given its new sequence number, and one that is too large is split in two, which
+-- are the only times a CRC is calculated here. If the frame pool has no buffer for the second half, the frame is sent
+-- whole. Once the prefetcher has handed out the whole file there is nothing more
+-- to send, and it goes back to the start of the file when the EOT is sent.
+--
+-- If the prefetcher has no frame ready, the frames taken so far are sent and the rest of the window is filled after
+-- the next ACK. If nothing could be sent at all, this returns without changing any flags, and the prefetcher's
+-- frameReady signal runs the state machine again once a frame is ready.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::sendFrame()
 {
-	if (mTxFrameCount < 10)
+	while (mTxSent < mWindowSize && mTxFrameCount < MAX_TX_FRAMES)
 	{
-		mRTXCount = 0;
-		if (mFile->IsAtEndOfFile())
+		if (mTxSent == mTxWindow.size())
 		{
-			qDebug() << "end of file sending eot";
-			setFlag(RTS, false);
-			sendEOT();
+			PreparedFrame prepared;
+			FramePrefetcher::TakeResult result = mTxEndOfFile ? FramePrefetcher::END_OF_FILE
+				: mPrefetcher->TakeFrame(mTxBase + mTxSent, mTxDataLength, prepared);
+			if (result == FramePrefetcher::FRAME_NOT_READY)
+			{
+				qDebug() << "waiting for the frame prefetcher";
+				break;
+			}
+			if (result == FramePrefetcher::END_OF_FILE)
+			{
+				mTxEndOfFile = true;
+				break;
+			}
+			mTxWindow.append(prepared);
+			mTxSentAt.append(mClock.elapsed());
 		}
 		else
 		{
-			writeToPort(makeFrame(mFile->GetNextBytes()));
-			emit UpdateLabel("PacketReceived");
-			setFlag(SENT_DATA, true);
-			setFlag(RCV_ACK, false);
-			mTxFrameCount++;
-			qDebug() << "sendFrame starting timeout of 2s";
-			startTimeout(TIMEOUT_LEN);
+			PreparedFrame& entry = mTxWindow[mTxSent];
+			if (entry.chunk.length > mTxDataLength)
+			{
+				PreparedFrame tail;
+				tail.chunk.offset = entry.chunk.offset + mTxDataLength;
+				tail.chunk.length = entry.chunk.length - mTxDataLength;
+				tail.frame = mFramePool.Acquire();
+				if (tail.frame != nullptr)
+				{
+					FrameWriter::WriteDataFrame(mTxBase + mTxSent + 1,
+						ByteView(*entry.frame).Mid(DATA_HEADER_SIZE + mTxDataLength, tail.chunk.length), *tail.frame);
+					entry.chunk.length = mTxDataLength;
+					mTxWindow.insert(mTxSent + 1, tail);
+					mTxSentAt.insert(mTxSent + 1, -1);
+				}
+			}
+			FrameWriter::Reframe(*mTxWindow[mTxSent].frame, mTxBase + mTxSent, mTxWindow[mTxSent].chunk.length);
+			mTxSentAt[mTxSent] = -1;
 		}
+
+		writeToPort(*mTxWindow[mTxSent].frame);
+		emit UpdateLabel("PacketReceived");
+		mTxSent++;
+		mTxFrameCount++;
 	}
-	else
+
+	if (mTxSent == 0)
 	{
-		qDebug() << "hit transmission cap, sending eot";
+		if (!mTxEndOfFile && mTxFrameCount < MAX_TX_FRAMES)
+		{
+			return;
+		}
+		if (mTxEndOfFile)
+		{
+			qDebug() << "end of file sending eot";
+			mTxEndOfFile = false;
+			mPrefetcher->Rewind();
+			setFlag(RTS, false);
+		}
+		else
+		{
+			qDebug() << "hit transmission cap, sending eot";
+		}
 		sendEOT();
+		return;
 	}
+
+	updateFlags(SENT_DATA, RCV_ACK);
+	qDebug() << "sendFrame starting timeout of" << mTxRtt.GetTimeout() << "ms";
+	startTimeout(mTxRtt.GetTimeout(), false);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -404,7 +882,12 @@ void IOThread::sendFrame()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Goes back to the oldest unacknowledged frame and resends the window.
+--					Oct 16, 2026 - Only resends the missing frames in selective repeat mode.
+--					Oct 16, 2026 - Counts the resent frames as lost for the frame size estimate.
+--					Oct 16, 2026 - Backs off the measured timeout and stops timing the resent frames.
+--					Oct 16, 2026 - Sends the frames again from the mapped file.
+--					Oct 16, 2026 - Resends the frames that were kept in the window.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -415,22 +898,44 @@ void IOThread::sendFrame()
 -- RETURNS:			void.
 --
 -- NOTES:
--- This function handles retransmission of the previous frame. 
+-- This function handles retransmission of the unacknowledged frames. 
+--
+-- If retransmissoin count has not been hit, every frame from the oldest unacknowledged frame onwards is sent again,
+-- the retransmission counter is incremented and the related flags are set. In selective repeat mode the frames that
+-- the other side has already reported as received are skipped. Every frame that had not been reported as received is
+-- counted as lost and the frame size is adjusted. Otherwise teardown the session and go back to default state. The
+-- unacknowledged frames are kept and are sent first in the next session.
 --
--- If retransmissoin count has not been hit, retransmit the previous frame and increment the retransmission counter
--- and set the related flags. Otherwise teardown the session and go back to default state.
+-- A resent frame is no longer used for the round trip estimate since the ACK for it could belong to either copy. The
+-- timeout is doubled instead and stays that way until a frame that was only sent once is acknowledged.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::resendFrame()
 {
 	if (mRTXCount < 3)
 	{
-		qDebug() << mRTXCount << "time resending frame" << mTxFrameCount;
-		writeToPort(makeFrame(mFile->GetPreviousBytes()));
-		setFlag(SENT_DATA, true);
-		setFlag(RCV_ACK, false);
+		qDebug() << mRTXCount << "time resending from frame" << mTxBase;
+		for (int i = 0; i < mTxSent; i++)
+		{
+			if (mTxAcked & (1u << i))
+			{
+				if (mArqMode == SELECTIVE_REPEAT)
+				{
+					continue;
+				}
+			}
+			else
+			{
+				recordFrameOutcome(mTxWindow[i].chunk.length, true);
+			}
+			writeToPort(*mTxWindow[i].frame);
+			mTxSentAt[i] = -1;
+		}
+		adaptDataLength();
+		mTxRtt.Backoff();
+		updateFlags(SENT_DATA, RCV_ACK);
 		mRTXCount++;
-		qDebug() << "resendFrame starting timeout of 2s";
-		startTimeout(TIMEOUT_LEN);
+		qDebug() << "resendFrame starting timeout of" << mTxRtt.GetTimeout() << "ms";
+		startTimeout(mTxRtt.GetTimeout(), false);
 	}
 	else
 	{
@@ -445,7 +950,11 @@ void IOThread::resendFrame()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Sends the next expected sequence number and a bitmap of received frames, protected by a CRC-32.
+--					Oct 16, 2026 - Waits for the measured gap between an ACK and the next data frame.
+--					Oct 16, 2026 - Waits long enough for the sender to resend at least twice.
+--					Oct 16, 2026 - Uses the shared CRC-32 lookup table.
+--					Oct 16, 2026 - Uses the hardware CRC-32 when the processor has it.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -458,15 +967,23 @@ void IOThread::resendFrame()
 -- NOTES:
 -- Sends an ACK frame through the serial port, sets flags to represent that state, and starts a timer that waits
 -- for a response.
+--
+-- The ACK frame carries the sequence number of the next data frame that is expected, which acknowledges every frame
+-- before it, the number of data bytes per frame that was agreed on, and a bitmap of the frames after the expected one
+-- which have already been received. A CRC-32 of the type and the fields follows, since a damaged sequence number or
+-- bitmap would slide the other side's window past frames that never arrived.
+--
+-- The time the ACK was sent is kept so the receiver can learn how long the sender takes to answer. The receiver waits
+-- for getReceiveTimeout, which also allows for the sender resending a lost frame or answering a lost ACK.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::sendACK()
 {
-	emit writeToPort(ACK_FRAME);
-	setFlag(SENT_ACK, true);
-	setFlag(RCV_DATA, false);
+	emit writeToPort(mFrameWriter.WriteACK(mRxExpectedSeq, (uint16_t)mRxDataLength, mRxReceived));
+	updateFlags(SENT_ACK, RCV_DATA);
 	emit UpdateLabel("ACK");
-	qDebug() << "sendACK starting timeout of 2s";
-	startTimeout(TIMEOUT_LEN * 3);
+	mRxAckSentAt = mClock.elapsed();
+	qDebug() << "sendACK starting timeout of" << getReceiveTimeout() << "ms";
+	startTimeout(getReceiveTimeout(), false);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -474,7 +991,12 @@ void IOThread::sendACK()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Carries the largest payload size, protected by a CRC-32.
+--					Oct 16, 2026 - Times the ENQ and waits for the measured timeout.
+--					Oct 16, 2026 - Announces the retransmission timeout.
+--					Oct 16, 2026 - Uses the shared CRC-32 lookup table.
+--					Oct 16, 2026 - Uses the hardware CRC-32 when the processor has it.
+--					Oct 16, 2026 - Announces the size of the file and the offset the session starts at.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -487,14 +1009,32 @@ void IOThread::sendACK()
 -- NOTES:
 -- Sends an ENQ frame through the serial port, sets flags to represent that state, and starts a timer that waits
 -- for a response.
+--
+-- The ENQ frame carries the largest number of data bytes per frame that this side wants to use, the size of the file
+-- and the offset in the file of the first frame that will be sent, so the other side can save the file as it arrives.
+-- It also carries the current retransmission timeout, so the other side knows how long it may take for a lost frame
+-- or a lost ACK to be answered. A CRC-32 of the type and the fields follows.
+--
+-- Sequence numbers start at 0 for every session. Frames left in the window from a previous session are renumbered
+-- and will be sent first, and the frames the prefetcher already built are renumbered to follow them.
+--
+-- The ACK for an ENQ is never ambiguous, so the time the ENQ was sent is kept for the round trip estimate.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::sendENQ()
 {
-	emit writeToPort(ENQ_FRAME);
+	mTxBase = 0;
+	mTxSent = 0;
+	mTxAcked = 0;
+	mTxFrameCount = 0;
+	mRTXCount = 0;
+	qint64 offset = mTxWindow.isEmpty() ? mPrefetcher->GetNextOffset() : mTxWindow.first().chunk.offset;
+	emit writeToPort(mFrameWriter.WriteENQ((uint16_t)mMaxDataLength, mFile->GetSize(), offset,
+		(uint16_t)qMin(mTxRtt.GetTimeout(), 0xFFFF)));
 	setFlag(SENT_ENQ, true);
-	qDebug() << "sendENQ starting timeout of 2s x3";
+	mTxEnqSentAt = mClock.elapsed();
+	qDebug() << "sendENQ starting timeout of" << mTxRtt.GetTimeout() << "ms";
 
-	startTimeout(TIMEOUT_LEN);
+	startTimeout(mTxRtt.GetTimeout(), false);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -520,9 +1060,7 @@ void IOThread::sendEOT()
 {
 	emit writeToPort(EOT_FRAME);
 	mTxFrameCount = 0;
-	setFlag(SENT_EOT, true);
-	setFlag(FIN, true);
-	setFlag(SENT_ENQ, false);
+	updateFlags(SENT_EOT | FIN, SENT_ENQ);
 	qDebug() << "sendEOT starting timeout of 2s";
 	startTimeout(TIMEOUT_LEN);
 }
@@ -553,13 +1091,41 @@ void IOThread::sendRVI()
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: backoff()
+-- FUNCTION: sendNAK()
 --
--- DATE:			Dec 05, 2017
+-- DATE:			Oct 16, 2026
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Uses the shared CRC-32 lookup table.
+--					Oct 16, 2026 - Uses the hardware CRC-32 when the processor has it.
 --
--- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void sendNAK(const uint8_t seq)	
+--						const uint8_t seq: The sequence number in the header of the frame that failed its check.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Sends a NAK frame through the serial port so the other side resends a corrupted frame without waiting for its
+-- timeout. The sequence number comes from a frame that failed its CRC check so it may itself be wrong, the other
+-- side checks it against its window. The NAK itself ends in a CRC-32 so a damaged one is not taken for another frame.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::sendNAK(const uint8_t seq)
+{
+	emit writeToPort(mFrameWriter.WriteNAK(seq));
+	emit UpdateLabel("NAK");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: backoff()
+--
+-- DATE:			Dec 05, 2017
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
 -- PROGRAMMER:		Delan Elliot
 --
@@ -573,8 +1139,7 @@ void IOThread::sendRVI()
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::backoff()
 {
-	setFlag(FIN, true);
-	setFlag(SENT_ENQ, false);
+	updateFlags(FIN, SENT_ENQ);
 	qDebug() << "backoff starting timeout of 2s";
 	startTimeout(TIMEOUT_LEN);
 }
@@ -584,7 +1149,8 @@ void IOThread::backoff()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Runs on the I/O thread and handles the data right away.
+--					Oct 16, 2026 - Reads from the transport straight into the frame parser.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -595,14 +1161,27 @@ void IOThread::backoff()
 -- RETURNS:			void.
 --
 -- NOTES:
--- This is a Qt slot.
---
--- When there is new data on the serial port it its read to a buffer and a function is called to check the buffer.
+-- Called on the I/O thread when there is new data on the serial port. The data is read straight into the ring buffer
+-- of the frame parser, as much as fits in one read, and the frames in it are handled right away. If the read filled
+-- the space up to the end of the ring buffer, there may be more waiting, so it reads again from the start.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::GetDataFromPort()
 {
-	mBuffer += mPort->readAll();
-	handleBuffer();
+	int length;
+	qint64 read;
+
+	do
+	{
+		char* space = mParser.GetWriteSpace(length);
+		read = mPort->Read(space, length);
+		if (read > 0)
+		{
+			mParser.CommitWrite((int)read);
+			handleBuffer();
+		}
+	} while (read > 0 && read == length);
+
+	handleEvents();
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -610,7 +1189,15 @@ void IOThread::GetDataFromPort()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Consumes every frame in the buffer instead of clearing it after the first one.
+--					Oct 16, 2026 - Drops ACK, NAK and ENQ frames that fail their CRC.
+--					Oct 16, 2026 - Keeps the retransmission timeout the sender announces in its ENQ.
+--					Oct 16, 2026 - Handles NAK frames.
+--					Oct 16, 2026 - Takes whole frames from the frame parser instead of searching the buffer.
+--					Oct 16, 2026 - Handles each frame where it is in the frame parser instead of copying it.
+--					Oct 16, 2026 - Starts and finishes the receive sinks on an ENQ and an EOT.
+--					Oct 16, 2026 - The bytes are already in the frame parser when it is called.
+--					Oct 17, 2026 - Looks for the next frame inside a control frame that fails its CRC.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -621,48 +1208,248 @@ void IOThread::GetDataFromPort()
 -- RETURNS:			void.
 --
 -- NOTES:
--- When data is read to the buffer this function checks the data in the buffer.
+-- When data is read into the frame parser this function checks the data in it.
+--
+-- The frame parser hands back every complete frame the bytes finish, since a full window of frames can arrive in a
+-- single read. If there is a control frame, the flags are set to represent that control
+-- frame. If there is a data frame a function is called to handle the data frame. A frame that has not fully arrived
+-- is kept by the parser until the rest of it is read.
+--
+-- Each frame is handled before the next one is parsed, so an ENQ that changes the largest data frame applies to the
+-- frames right behind it. An ENQ also drops any frames left in the receive window from the last session.
+--
+-- An ACK, NAK or ENQ whose CRC does not match is dropped as if it had never arrived. The retransmission timer recovers
+-- from it the same way it recovers from a lost frame. The frame parser is told to look for the next frame from the
+-- byte after its SYN, since a damaged frame may have hidden the start of the next one.
+--
+-- The retransmission timeout of the sender is kept from every ENQ for getReceiveTimeout.
 --
--- If there is a control frame, the flags are sent to represent that control frame and the buffer is cleared.
--- If there is a data frame a function is called to handle the data frame.
+-- The receive sinks are told about the file and where the session starts in it on every ENQ, and that the other side
+-- is done sending on every EOT.
+--
+-- Every frame is a view into the frame parser, which stays valid until the next bytes are read into it.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::handleBuffer()
 {
-	if (mBuffer.contains(ENQ_FRAME))
+	ByteView frame;
+
+	while (mParser.ReadFrame(frame))
+	{
+		switch (frame[1])
+		{
+		case ENQ:
+			if (!isControlFrameValid(frame))
+			{
+				qDebug() << "dropped an enq that failed its crc";
+				mParser.Reject();
+				break;
+			}
+			mRxDataLength = qBound(MIN_DATA_LENGTH, ((uint8_t)frame[2] << 8) | (uint8_t)frame[3], mMaxDataLength);
+			mParser.SetMaxDataLength(mRxDataLength);
+			mRxPeerTimeout = ((uint8_t)frame[20] << 8) | (uint8_t)frame[21];
+			qDebug() << "received enq, using" << mRxDataLength << "bytes per frame";
+			mRxExpectedSeq = 0;
+			mRxReceived = 0;
+			releaseRxWindow();
+			for (ReceiveSink* sink : mRxSinks)
+			{
+				sink->Start(getInt64(frame, 4), getInt64(frame, 12));
+			}
+			setFlag(RCV_ENQ, true);
+			break;
+		case ACK:
+			if (!isControlFrameValid(frame))
+			{
+				qDebug() << "dropped an ack that failed its crc";
+				mParser.Reject();
+				break;
+			}
+			handleACK((uint8_t)frame[2], ((uint8_t)frame[3] << 8) | (uint8_t)frame[4],
+				((uint8_t)frame[5] << 24) | ((uint8_t)frame[6] << 16) | ((uint8_t)frame[7] << 8) | (uint8_t)frame[8]);
+			break;
+		case NAK:
+			if (!isControlFrameValid(frame))
+			{
+				qDebug() << "dropped a nak that failed its crc";
+				mParser.Reject();
+				break;
+			}
+			handleNAK((uint8_t)frame[2]);
+			break;
+		case EOT:
+			qDebug() << "received eot";
+			for (ReceiveSink* sink : mRxSinks)
+			{
+				sink->Finish();
+			}
+			setFlag(RCV_EOT, true);
+			break;
+		case RVI:
+			qDebug() << "received RVI";
+			setFlag(RCV_RVI, true);
+			mTxFrameCount = 0;
+			break;
+		case STX:
+			checkPotentialDataFrame(frame);
+			break;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: handleACK()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Records the frames reported in the bitmap for selective repeat.
+--					Oct 16, 2026 - Takes a round trip sample from the frames it acknowledges.
+--					Oct 16, 2026 - Gives the buffers of acknowledged frames back to the frame buffer pool.
+--					Oct 16, 2026 - Only drops the offset and length of acknowledged frames.
+--					Oct 16, 2026 - Gives the prefetched frames it acknowledges back to the frame buffer pool.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void handleACK(const uint8_t seq, const uint32_t received)	
+--						const uint8_t seq: The sequence number of the next frame the other side expects.
+--						const uint16_t dataLength: The number of data bytes per frame the other side agreed to.
+--						const uint32_t received: Bit i is set if frame seq + 1 + i has already been received.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Slides the send window forward past every frame the ACK covers and sets the flags to represent that an ACK was
+-- received. The frames in the bitmap are marked so that they are not resent in selective repeat mode and are not
+-- counted as lost in either mode.
+--
+-- Every frame that is acknowledged for the first time counts as delivered for the frame size estimate, and the frame
+-- size is adjusted whenever something new was acknowledged. The size the receiver agreed to is the upper limit. The
+-- latest frame that is acknowledged for the first time and was only sent once, or the ENQ, gives a round trip sample.
+--
+-- An ACK that does not move the window while frames are outstanding is either a duplicate or only reports frames
+-- that arrived out of order. Nothing new can be sent, so the flags are left alone and the retransmission timer keeps
+-- running for the oldest frame.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::handleACK(const uint8_t seq, const uint16_t dataLength, const uint32_t received)
+{
+	int acknowledged = (uint8_t)(seq - mTxBase);
+
+	if (acknowledged > mTxSent)
 	{
-		qDebug() << "received enq";
-		setFlag(RCV_ENQ, true);
-		mBuffer.clear();
+		qDebug() << "ignoring ack" << seq;
+		return;
 	}
 
-	if (mBuffer.contains(ACK_FRAME))
+	qDebug() << "received ack" << seq;
+	qint64 sentAt = mTxEnqSentAt;
+	mTxEnqSentAt = -1;
+	for (int i = 0; i < acknowledged; i++)
 	{
-		qDebug() << "received ack";
-		setFlag(RCV_ACK, true);
-		setFlag(TOR, false);
-		mBuffer.clear();
+		if (!(mTxAcked & (1u << i)))
+		{
+			recordFrameOutcome(mTxWindow.first().chunk.length, false);
+			sentAt = qMax(sentAt, mTxSentAt.first());
+		}
+		mFramePool.Release(mTxWindow.takeFirst().frame);
+		mTxSentAt.removeFirst();
+	}
+	mTxBase = seq;
+	mTxSent -= acknowledged;
+	mTxAcked = acknowledged < 32 ? mTxAcked >> acknowledged : 0;
 
+	uint32_t newlyReceived = (received << 1) & (mTxSent < 32 ? (1u << mTxSent) - 1 : 0xFFFFFFFF) & ~mTxAcked;
+	for (int i = 0; i < mTxSent; i++)
+	{
+		if (newlyReceived & (1u << i))
+		{
+			recordFrameOutcome(mTxWindow[i].chunk.length, false);
+			sentAt = qMax(sentAt, mTxSentAt[i]);
+		}
 	}
+	mTxAcked |= newlyReceived;
 
-	if (mBuffer.contains(EOT_FRAME))
+	if (sentAt >= 0)
 	{
-		qDebug() << "received eot";
-		setFlag(RCV_EOT, true);
-		mBuffer.clear();
+		mTxRtt.AddSample(mClock.elapsed() - sentAt);
+		qDebug() << "round trip" << mClock.elapsed() - sentAt << "ms, timeout" << mTxRtt.GetTimeout() << "ms";
 	}
 
-	if (mBuffer.contains(RVI_FRAME))
+	mTxDataLimit = qBound(MIN_DATA_LENGTH, (int)dataLength, mMaxDataLength);
+	if (acknowledged > 0 || newlyReceived)
 	{
-		qDebug() << "received RVI";
-		setFlag(RCV_RVI, true);
-		mTxFrameCount = 0;
-		mBuffer.clear();
+		adaptDataLength();
 	}
+	mTxDataLength = qMin(mTxDataLength, mTxDataLimit);
 
-	if (mBuffer.contains(SYN_BYTE + STX_BYTE))
+	if (acknowledged == 0 && mTxSent > 0)
 	{
-		checkPotentialDataFrame();
+		return;
 	}
+
+	mRTXCount = 0;
+	updateFlags(RCV_ACK, TOR);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: handleNAK()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Sends the frames again from the mapped file.
+--					Oct 16, 2026 - Resends the frame that was kept in the window.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void handleNAK(const uint8_t seq)	
+--						const uint8_t seq: The sequence number of the frame the other side could not read.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Resends a frame the other side reported as corrupted right away. In selective repeat mode only that frame is
+-- resent, in Go-Back-N mode every frame from it onwards is resent.
+--
+-- The sequence number was read from a corrupted frame, so if it is not an outstanding frame that has not been
+-- acknowledged the oldest unacknowledged frame is resent instead. The resent frames count as lost for the frame size
+-- estimate and are no longer used for the round trip estimate. The retransmission timer is left running.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::handleNAK(const uint8_t seq)
+{
+	if (!isFlagSet(SENT_DATA) || mTxSent == 0)
+	{
+		qDebug() << "ignoring nak" << seq;
+		return;
+	}
+
+	int first = (uint8_t)(seq - mTxBase);
+	if (first >= mTxSent || (mTxAcked & (1u << first)))
+	{
+		first = 0;
+		while (first < mTxSent && (mTxAcked & (1u << first)))
+		{
+			first++;
+		}
+		if (first == mTxSent)
+		{
+			return;
+		}
+	}
+
+	qDebug() << "received nak" << seq << "resending frame" << (uint8_t)(mTxBase + first);
+	int last = mArqMode == SELECTIVE_REPEAT ? first + 1 : mTxSent;
+	for (int i = first; i < last; i++)
+	{
+		if (!(mTxAcked & (1u << i)))
+		{
+			recordFrameOutcome(mTxWindow[i].chunk.length, true);
+		}
+		writeToPort(*mTxWindow[i].frame);
+		mTxSentAt[i] = -1;
+	}
+	adaptDataLength();
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -670,42 +1457,98 @@ void IOThread::handleBuffer()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Frames that arrive out of sequence are buffered until the gap is filled.
+--					Oct 16, 2026 - Times the first valid frame after an ACK and waits for the measured timeout.
+--					Oct 16, 2026 - Waits long enough for the sender to resend at least twice.
+--					Oct 16, 2026 - Answers a frame that fails its check with a NAK.
+--					Oct 16, 2026 - Is given the frame by the frame parser.
+--					Oct 16, 2026 - Buffers out of sequence frames in buffers from the frame buffer pool.
+--					Oct 16, 2026 - Is given a view of the frame in the frame parser.
+--					Oct 17, 2026 - Looks for the next frame inside a data frame that fails its CRC.
+--					Oct 17, 2026 - Drops an out of sequence frame when the frame buffer pool has no buffer for it.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
 -- PROGRAMMER:		Benny Wang, Delan Elliot, Roger Zhang
 --
--- INTERFACE:		void checkPotentialDataFrame()	
+-- INTERFACE:		void checkPotentialDataFrame(const ByteView& dataFrame)	
+--						const ByteView& dataFrame: A view of a complete frame in the frame parser.
 --
 -- RETURNS:			void.
 --
 -- NOTES:
--- This function is called when there is potentially a valid data frame in the buffer.
---
--- This function grabs the frame from the buffer and checks it. If the frame is a valid data frame, flags are sent to
--- represent that state and the data is extracted and the buffer gets cleared. Otherwise if the frame is not a valid
--- data frame, the flags are set to represent that state and a time is started.
+-- This function is called when the frame parser finds something that looks like a data frame.
+--
+-- This function checks the frame. If the frame is a valid data frame, flags are set to
+-- represent that state. If it is the frame that was expected next its data is delivered along with every buffered
+-- frame that directly follows it. A frame further ahead in the receive window is buffered and marked in the bitmap
+-- that is sent with the next ACK. Anything else is a duplicate and is dropped. If the frame is not a valid data frame,
+-- a NAK is sent so it is resent right away, and the flags are set to represent that state and a time is started.
+-- The frame parser then looks for the next frame from the byte after the SYN of the bad one, so a damaged length
+-- does not take the frames behind it down too. Since the bytes inside a damaged frame can look like a frame as well,
+-- the NAK is only sent for a sequence number the receive window could hold.
+--
+-- The first valid frame after an ACK gives a sample of how long the sender takes to answer, which sets how long the
+-- receiver waits.
+--
+-- A frame that is delivered right away is handed to the receive sinks as a view into the frame parser, so it is not
+-- copied. A buffered frame is copied into a buffer from the frame buffer pool, which is given back once it has been
+-- delivered. If the pool has no buffer to lend, the frame is dropped as if it never arrived and is sent again.
 ----------------------------------------------------------------------------------------------------------------------*/
-void IOThread::checkPotentialDataFrame()
+void IOThread::checkPotentialDataFrame(const ByteView& dataFrame)
 {
-	int dataFrameStart = mBuffer.indexOf(SYN_BYTE + STX_BYTE);
-	QByteArray dataFrame = mBuffer.mid(dataFrameStart, DATA_FRAME_SIZE);
-
 	if (isDataFrameValid(dataFrame))
 	{
 		qDebug() << "data frame valid";
-		setFlag(RCV_DATA, true);
-		setFlag(RCV_ERR, false);
-		mFrameData = getDataFromFrame(dataFrame);
-		mBuffer.clear();
+		if (mRxAckSentAt >= 0)
+		{
+			mRxRtt.AddSample(mClock.elapsed() - mRxAckSentAt);
+			mRxAckSentAt = -1;
+		}
+		updateFlags(RCV_DATA, RCV_ERR);
+		int offset = (uint8_t)((uint8_t)dataFrame[2] - mRxExpectedSeq);
+		if (offset == 0)
+		{
+			deliverFrame(dataFrame.Mid(DATA_HEADER_SIZE, dataFrame.size - DATA_HEADER_SIZE - CRC_LENGTH));
+			while (mRxReceived & 1)
+			{
+				mRxReceived >>= 1;
+				QByteArray*& buffered = mRxWindow[mRxExpectedSeq % MAX_WINDOW_SIZE];
+				deliverFrame(*buffered);
+				mFramePool.Release(buffered);
+				buffered = nullptr;
+			}
+			mRxReceived >>= 1;
+		}
+		else if (offset < MAX_WINDOW_SIZE)
+		{
+			qDebug() << "buffering out of sequence frame" << (uint8_t)dataFrame[2] << "expected" << mRxExpectedSeq;
+			QByteArray*& buffered = mRxWindow[(uint8_t)dataFrame[2] % MAX_WINDOW_SIZE];
+			if (buffered == nullptr)
+			{
+				buffered = mFramePool.Acquire();
+			}
+			if (buffered != nullptr)
+			{
+				getDataFromFrame(dataFrame, *buffered);
+				mRxReceived |= 1u << (offset - 1);
+			}
+		}
+		else
+		{
+			qDebug() << "duplicate frame" << (uint8_t)dataFrame[2] << "expected" << mRxExpectedSeq;
+		}
 	}
 	else
 	{
-		qDebug() << "data frame invalid starting timeout of 6s";
-		setFlag(RCV_DATA, true);
-		setFlag(RCV_ERR, true);
-		startTimeout(TIMEOUT_LEN * 3);
+		qDebug() << "data frame invalid starting timeout of" << getReceiveTimeout() << "ms";
+		if ((uint8_t)((uint8_t)dataFrame[2] - mRxExpectedSeq) < MAX_WINDOW_SIZE)
+		{
+			sendNAK((uint8_t)dataFrame[2]);
+		}
+		mParser.Reject();
+		updateFlags(RCV_DATA | RCV_ERR, 0);
+		startTimeout(getReceiveTimeout(), false);
 	}
 	emit UpdateLabel(QString::number(byteError / (byteError + byteValid) * 100));
 }
@@ -715,7 +1558,12 @@ void IOThread::checkPotentialDataFrame()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Sleeps until an event or timeout instead of polling every 100ms.
+--					Oct 16, 2026 - Owns the serial port and runs its own event loop instead of waiting on a condition.
+--					Oct 16, 2026 - Refills the port from the write queue whenever it writes bytes.
+--					Oct 16, 2026 - Talks to the port through the transport for this platform.
+--					Oct 16, 2026 - Makes a new transport each time a port is selected.
+--					Oct 16, 2026 - Opens a newly selected file on this thread.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -730,139 +1578,177 @@ void IOThread::checkPotentialDataFrame()
 -- 
 -- When the program first enters the thread all flags are reset.
 -- 
--- While the program is running, this function will contuniously check the flags of the program and execute function
--- based on what state the program is in.
+-- The transport to the serial port and the timeout timer are created here so they belong to this thread, and the
+-- thread then runs its own event loop. Received bytes, posted events, timeouts and port changes are all handled by
+-- that loop, so the protocol never waits on the GUI thread. Each time the port has written some bytes, more are taken
+-- from the write queue. The IOThread object itself belongs to the GUI thread, so the connections use the timer or the
+-- port as their context to run on this thread. The port is replaced each time a new one is selected. A newly selected
+-- file is opened on this thread too, so the file is never swapped under a frame that is being sent. Both are
+-- connected in the constructor. The loop ends when the thread is told to quit.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::run()
 {
+	QTimer timer;
+	timer.setSingleShot(true);
+	timer.setTimerType(Qt::PreciseTimer);
+
+	mTimer = &timer;
+	createPort(QString());
+
+	connect(&timer, &QTimer::timeout, &timer, [this] { handleEvents(); });
+	connect(this, &IOThread::eventPosted, &timer, [this] { handleEvents(); }, Qt::QueuedConnection);
+
 	resetFlags();
+	handleEvents();
+	exec();
 
-	while (mRunning)
+	mPort->Close();
+	delete mPort;
+	mPort = nullptr;
+	mTimer = nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: processState()
+--
+-- DATE:			Dec 05, 2017
+--
+-- REVISIONS:		Oct 16, 2026 - Moved out of run() so it can be called once per event.
+--					Oct 16, 2026 - Flushes the receive sinks after acknowledging data.
+--
+-- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
+--
+-- PROGRAMMER:		Delan Elliot, Roger Zhang
+--
+-- INTERFACE:		void processState()	
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Checks the flags of the program once and executes the function that matches the state the program is in.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::processState()
+{
+	if (isFlagSet(SEND_RVI))
 	{
-		updateTimeout();
-		if (isFlagSet(SEND_RVI))
-		{
-			sendRVI();
-		}
+		sendRVI();
+	}
 
-		if (isFlagSet(RCV_ENQ))
+	if (isFlagSet(RCV_ENQ))
+	{
+		if (isFlagSet(FIN))
 		{
-			if (isFlagSet(FIN))
+			if (isFlagSet(SENT_ACK))
 			{
-				if (isFlagSet(SENT_ACK))
+				if (isFlagSet(RCV_EOT))
 				{
-					if (isFlagSet(RCV_EOT))
+					if (isFlagSet(RTS))
 					{
-						if (isFlagSet(RTS))
+						resetFlagsNoTimeout();
+					}
+					else
+					{
+						resetFlagsNoTimeout();
+					}
+				}
+				else
+				{
+					if (isFlagSet(RCV_DATA))
+					{
+						if (isFlagSet(RCV_ERR))
 						{
-							resetFlagsNoTimeout();
+							updateFlags(0, RCV_ERR | RCV_DATA);
 						}
 						else
 						{
-							resetFlagsNoTimeout();
+							sendACK();
+							flushReceiveSinks();
 						}
 					}
+					// RCV_data is false
 					else
 					{
-						if (isFlagSet(RCV_DATA))
+						if (!isFlagSet(TOR))
 						{
-							if (isFlagSet(RCV_ERR))
-							{
-								setFlag(RCV_ERR, false);
-								setFlag(RCV_DATA, false);
-							}
-							else
-							{
-								sendACK();
-								emit DataReceieved(mFrameData);
-							}
-						}
-						// RCV_data is false
-						else
-						{
-							if (!isFlagSet(TOR))
-							{
-								resetFlagsNoTimeout();
-							}
+							resetFlagsNoTimeout();
 						}
 					}
 				}
-				else
-				{
-					sendACK();
-				}
 			}
 			else
 			{
-				setFlag(RCV_ENQ, false);
+				sendACK();
 			}
 		}
-		// RCV_ENQ false
 		else
 		{
-			if (isFlagSet(RCV_RVI))
+			setFlag(RCV_ENQ, false);
+		}
+	}
+	// RCV_ENQ false
+	else
+	{
+		if (isFlagSet(RCV_RVI))
+		{
+			resetFlags();
+			return;
+		}
+
+		if (isFlagSet(RTS))
+		{
+			if (isFlagSet(FIN))
 			{
-				resetFlags();
-				continue;
+				if (isFlagSet(TOR))
+				{
+					return;
+				}
+				else
+				{
+					setFlag(FIN, false);
+				}
 			}
-
-			if (isFlagSet(RTS))
+			else
 			{
-				if (isFlagSet(FIN))
+				if (isFlagSet(SENT_ENQ))
 				{
-					if (isFlagSet(TOR))
+					if (isFlagSet(RCV_ACK))
 					{
-						continue;
+						sendFrame();
 					}
 					else
 					{
-						setFlag(FIN, false);
-					}
-				}
-				else
-				{
-					if (isFlagSet(SENT_ENQ))
-					{
-						if (isFlagSet(RCV_ACK))
+						if (isFlagSet(SENT_DATA))
 						{
-							sendFrame();
+							if (isFlagSet(TOR))
+							{
+								return;
+							}
+							else
+							{
+								//retransmit
+								resendFrame();
+							}
 						}
 						else
 						{
-							if (isFlagSet(SENT_DATA))
+							if (isFlagSet(TOR))
 							{
-								if (isFlagSet(TOR))
-								{
-									continue;
-								}
-								else
-								{
-									//retransmit
-									resendFrame();
-								}
+								return;
 							}
 							else
 							{
-								if (isFlagSet(TOR))
-								{
-									continue;
-								}
-								else
-								{
-									//back off
-									resetFlags();
-								}
+								//back off
+								resetFlags();
 							}
 						}
 					}
-					else
-					{
-						sendENQ();
-					}
+				}
+				else
+				{
+					sendENQ();
 				}
 			}
 		}
-		msleep(100);
 	}
 }
 
@@ -871,7 +1757,7 @@ void IOThread::run()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Keeps RTS and sets FIN in one atomic step.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -886,23 +1772,12 @@ void IOThread::run()
 -- 
 -- To reset flags, all flags are set to false except for RTS and FIN. RTS remains unchanged and FIN is set to true.
 -- This funciton will also set a timeout.
+--
+-- The flags are replaced in one step so an RTS set by the GUI while the flags are reset is never lost.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::resetFlags()
 {
-	if (isFlagSet(RTS))
-	{
-		mMutex.lock();
-		mFlags = 0;
-		mFlags |= RTS | FIN;
-		mMutex.unlock();
-	}
-	else
-	{
-		mMutex.lock();
-		mFlags = 0;
-		mFlags |= FIN;
-		mMutex.unlock();
-	}
+	updateFlags(FIN, ~(RTS | FIN));
 	qDebug() << "resetFlags starting timeout of 2s";
 	startTimeout(TIMEOUT_LEN);
 }
@@ -912,7 +1787,7 @@ void IOThread::resetFlags()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Keeps RTS and sets FIN in one atomic step.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -930,20 +1805,7 @@ void IOThread::resetFlags()
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::resetFlagsNoTimeout()
 {
-	if (isFlagSet(RTS))
-	{
-		mMutex.lock();
-		mFlags = 0;
-		mFlags |= RTS | FIN;
-		mMutex.unlock();
-	}
-	else
-	{
-		mMutex.lock();
-		mFlags = 0;
-		mFlags |= FIN;
-		mMutex.unlock();
-	}
+	updateFlags(FIN, ~(RTS | FIN));
 	qDebug() << "resetFlags no timeout";
 }
 
@@ -952,7 +1814,7 @@ void IOThread::resetFlagsNoTimeout()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Adds the frame to the write queue instead of writing and flushing it.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
@@ -964,75 +1826,169 @@ void IOThread::resetFlagsNoTimeout()
 -- RETURNS:			void.
 --
 -- NOTES:
--- Writes the given bites to the port.
+-- Queues the given bites to be written to the port. Nothing is written until the current event has been handled, so
+-- the frames sent while handling it are joined into as few writes as possible. Frames sent while no port is open are
+-- dropped, as the port would have done.
 ----------------------------------------------------------------------------------------------------------------------*/
 void IOThread::writeToPort(const QByteArray& frame)
 {
-	mPort->write(frame);
-	mPort->flush();
+	if (!mPort->IsOpen())
+	{
+		return;
+	}
+
+	mTxQueue.append(frame);
+	mWriteQueueDepth = mTxQueue.size() - mTxQueueHead + (int)mPort->BytesToWrite();
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: makeFrame()
+-- FUNCTION: drainWriteQueue()
 --
--- DATE:			Dec 05, 2017
+-- DATE:			Oct 16, 2026
 --
 -- REVISIONS:		N/A 
 --
--- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
+-- DESIGNER:		Benny Wang
 --
 -- PROGRAMMER:		Benny Wang
 --
--- INTERFACE:		void makeFrame(const QByteArray& data)
---						const QByteArray& data: The data to wrap in a frame.
+-- INTERFACE:		void drainWriteQueue()
 --
 -- RETURNS:			void.
 --
 -- NOTES:
--- Wraps the given data in a frame.
+-- Hands as many queued bytes to the port as fit in WRITE_AHEAD_SIZE, in a single write. Called once the current event
+-- has been handled, so every frame it produced goes out together, and again every time the port reports that bytes
+-- were written, so the port always has the next frames ready before it runs out.
 --
--- A frame consists of a a header, data, and CRC-32. The header is a SYN byte followed by a STX byte. The data is a
--- string of regular ASCII of length 512. The CRC-32 is calculated on the 512 bytes of data only.
---
--- The details of the CRC-32 used are:
---		polynomial     = 0x04C11DB7
---		initial value  = 0xFFFFFFFF
---		final XOR      = 0xFFFFFFFF
---		reflect input  = true
---		reflect output = true
---		check value    = 0xCBF43926
+-- The port never holds more than WRITE_AHEAD_SIZE bytes, so the rest wait in the queue. The queue is only emptied
+-- when everything in it was written, which keeps its memory for the next frames.
 ----------------------------------------------------------------------------------------------------------------------*/
-QByteArray IOThread::makeFrame(const QByteArray& data)
+void IOThread::drainWriteQueue()
 {
-	QByteArray stuffedData = QByteArray(DATA_LENGTH - data.size(), 0x0);
-	stuffedData.prepend(data);
-	uint32_t crc = CRC::Calculate(stuffedData.data(), DATA_LENGTH, CRC::CRC_32());
+	int room = WRITE_AHEAD_SIZE - (int)mPort->BytesToWrite();
+	int pending = mTxQueue.size() - mTxQueueHead;
 
-	QByteArray frame = SYN_BYTE + STX_BYTE + stuffedData;
-	frame = frame << crc;
+	if (room > 0 && pending > 0 && mPort->IsOpen())
+	{
+		qint64 written = mPort->Write(mTxQueue.constData() + mTxQueueHead, qMin(room, pending));
+		if (written > 0)
+		{
+			mTxQueueHead += (int)written;
+		}
+		if (mTxQueueHead == mTxQueue.size())
+		{
+			mTxQueue.resize(0);
+			mTxQueueHead = 0;
+		}
+	}
 
-	return frame;
+	mWriteQueueDepth = mTxQueue.size() - mTxQueueHead + (int)mPort->BytesToWrite();
 }
 
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: recordFrameOutcome()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Counts the bytes of the frame as sent instead of the padded frame size.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void recordFrameOutcome(const int dataLength, const bool lost)
+--						const int dataLength: The number of data bytes in the frame.
+--						const bool lost: True if the frame had to be resent, false if it was acknowledged.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Adds one sent frame to the error rate estimate used to pick the frame size.
+--
+-- The estimate only covers about the last ERROR_RATE_WINDOW frames. Older frames are faded out each time a new one is
+-- recorded so the frame size can follow the line as its quality drifts.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::recordFrameOutcome(const int dataLength, const bool lost)
+{
+	const double keep = 1.0 - 1.0 / ERROR_RATE_WINDOW;
+
+	mTxLostFrames = mTxLostFrames * keep + (lost ? 1 : 0);
+	mTxBytesSent = mTxBytesSent * keep + DATA_HEADER_SIZE + dataLength + CRC_LENGTH;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: adaptDataLength()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void adaptDataLength()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Picks the number of data bytes for the next frames from the recent error rate.
+--
+-- With a chance p of any byte being corrupted, a frame with L data bytes and H bytes of header and CRC gets through
+-- with a chance of (1 - p)^(L + H). The data delivered per byte sent is L / (L + H) * (1 - p)^(L + H), which is
+-- largest at L = (-H + sqrt(H^2 - 4H / ln(1 - p))) / 2. The byte error rate p is estimated as the number of lost
+-- frames over the number of bytes sent.
+--
+-- The size moves at most by a factor of two each time so a single lost frame does not throw it off, and it stays
+-- between MIN_DATA_LENGTH and the size the receiver agreed to.
+----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::adaptDataLength()
+{
+	const double overhead = DATA_HEADER_SIZE + CRC_LENGTH;
+	double target = mTxDataLimit;
+
+	if (mTxLostFrames > 0 && mTxBytesSent > 0)
+	{
+		double byteErrorRate = qMin(mTxLostFrames / mTxBytesSent, 0.5);
+		target = (-overhead + sqrt(overhead * overhead - 4 * overhead / log(1.0 - byteErrorRate))) / 2;
+	}
+
+	int dataLength = (int)qBound((double)mTxDataLength / 2, target, (double)mTxDataLength * 2);
+	dataLength = qBound(MIN_DATA_LENGTH, dataLength, mTxDataLimit);
+
+	if (dataLength != mTxDataLength)
+	{
+		qDebug() << "frame size" << mTxDataLength << "->" << dataLength;
+		mTxDataLength = dataLength;
+	}
+}
 
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: isDataFrameValid()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Uses the shared CRC-32 lookup table.
+--					Oct 16, 2026 - Uses the hardware CRC-32 when the processor has it.
+--					Oct 16, 2026 - Compares the CRC as a number instead of building a byte array for it.
+--					Oct 16, 2026 - Checks the frame where it is instead of copying the header and data out of it.
+--					Oct 16, 2026 - Takes a view of the frame.
+--					Oct 16, 2026 - Counts every data byte for the error rate now that frames are not padded.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
 -- PROGRAMMER:		Benny Wang
 --
--- INTERFACE:		bool isDataFrameValid(const QByteArray& frame)
---						const QByteArray& frame: The incoming data frame.
+-- INTERFACE:		bool isDataFrameValid(const ByteView& frame)
+--						const ByteView& frame: A view of the incoming data frame.
 --
 -- RETURNS:			True if the incoming frame has no errors, otherwise false.	
 --
 -- NOTES:
--- This function checks that the frame is the right size and that the recalcuated CRC matches the sent CRC.
+-- This function checks that the frame is the size given in its header and that the recalcuated CRC matches the sent
+-- CRC. The CRC covers the sequence number and the length as well as the data. Every data byte is real data, so all of
+-- them count towards the byte error rate.
 --
 -- The details of the CRC-32 used are:
 --		polynomial     = 0x04C11DB7
@@ -1041,47 +1997,234 @@ QByteArray IOThread::makeFrame(const QByteArray& data)
 --		reflect input  = true
 --		reflect output = true
 --		check value    = 0xCBF43926
+--
+-- The CRC is calculated with CRC::CalculateCRC32, the same as when FrameWriter builds the frame.
 ----------------------------------------------------------------------------------------------------------------------*/
-bool IOThread::isDataFrameValid(const QByteArray& frame)
+bool IOThread::isDataFrameValid(const ByteView& frame)
 {
-	// Check size (518 bytes)
-	if (frame.size() != DATA_FRAME_SIZE) return false;
+	int dataLength = frame.size - DATA_HEADER_SIZE - CRC_LENGTH;
+
+	// Check size (header, data and crc)
+	if (frame.size < DATA_HEADER_SIZE + CRC_LENGTH) return false;
+	if ((((uint8_t)frame[3] << 8) | (uint8_t)frame[4]) != dataLength) return false;
 
-	// Grab data (512 bytes)
-	QByteArray frameData = frame.mid(2, DATA_LENGTH);
+	// Sequence number, length and data
+	const char* frameData = frame.data + 2;
 
-	// Grab crc (4 bytes)
-	QByteArray receivedCrc = frame.mid(DATA_HEADER_SIZE + DATA_LENGTH);
+	// Grab crc (4 bytes, big endian)
+	int crcStart = DATA_HEADER_SIZE + dataLength;
+	uint32_t receivedCrc = ((uint32_t)(uint8_t)frame[crcStart] << 24) | ((uint8_t)frame[crcStart + 1] << 16)
+		| ((uint8_t)frame[crcStart + 2] << 8) | (uint8_t)frame[crcStart + 3];
 
-	QByteArray recalculatedCrc = QByteArray();
-	recalculatedCrc = recalculatedCrc << CRC::Calculate(frameData.data(), DATA_LENGTH, CRC::CRC_32());
+	uint32_t recalculatedCrc = CRC::CalculateCRC32(frameData, DATA_HEADER_SIZE - 2 + dataLength);
 
-	double stuffingCount = frameData.count(char(0x0));
-	recalculatedCrc == receivedCrc ? byteValid = byteValid + DATA_LENGTH - stuffingCount : byteError = byteError + DATA_LENGTH - stuffingCount;
+	recalculatedCrc == receivedCrc ? byteValid = byteValid + dataLength : byteError = byteError + dataLength;
 	return recalculatedCrc == receivedCrc;
 }
 
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: isControlFrameValid()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Uses the shared CRC-32 lookup table.
+--					Oct 16, 2026 - Uses the hardware CRC-32 when the processor has it.
+--					Oct 16, 2026 - Compares the CRC as a number instead of building a QByteArray.
+--					Oct 16, 2026 - Is given a view of the frame in the frame parser.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool isControlFrameValid(const ByteView& frame)
+--						const ByteView& frame: A view of an incoming ENQ, ACK or NAK frame.
+--
+-- RETURNS:			True if the CRC at the end of the frame matches, otherwise false.
+--
+-- NOTES:
+-- The CRC covers the type and every field after it, and is the same CRC-32 that covers data frames.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IOThread::isControlFrameValid(const ByteView& frame)
+{
+	if (frame.size < 2 + CRC_LENGTH) return false;
+
+	int crcStart = frame.size - CRC_LENGTH;
+	uint32_t receivedCrc = ((uint32_t)(uint8_t)frame[crcStart] << 24) | ((uint8_t)frame[crcStart + 1] << 16)
+		| ((uint8_t)frame[crcStart + 2] << 8) | (uint8_t)frame[crcStart + 3];
+
+	return CRC::CalculateCRC32(frame.data + 1, crcStart - 1) == receivedCrc;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: getReceiveTimeout()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		int getReceiveTimeout() const
+--
+-- RETURNS:			How long the receiver waits for the next data frame, in ms.
+--
+-- NOTES:
+-- The gap the receiver measures between its ACK and the next data frame is only about one frame long while the sender
+-- streams its window. The sender only resends after its own retransmission timeout, which is measured from when the
+-- whole window was queued and is announced in every ENQ. The receiver waits three times the longer of the two, which
+-- covers the first resend and the second one after the timeout doubles, so a lost frame or ACK is never given up on
+-- before the sender has tried again.
+----------------------------------------------------------------------------------------------------------------------*/
+int IOThread::getReceiveTimeout() const
+{
+	return qMax(mRxRtt.GetTimeout(), mRxPeerTimeout) * 3;
+}
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: getDataFromFrame()
 --
 -- DATE:			Dec 05, 2017
 --
--- REVISIONS:		N/A 
+-- REVISIONS:		Oct 16, 2026 - Copies the data into a buffer given by the caller.
+--					Oct 16, 2026 - Takes a view of the frame.
 --
 -- DESIGNER:		Benny Wang, Delan Elliot, Roger Zhang, Juliana French
 --
 -- PROGRAMMER:		Benny Wang
 --
--- INTERFACE:		QString getDataFromFrame(const QByteArray& frame)
---						const QByteArray& frame: A valid incoming data frame.
+-- INTERFACE:		void getDataFromFrame(const ByteView& frame, QByteArray& data)
+--						const ByteView& frame: A view of a valid incoming data frame.
+--						QByteArray& data: Set to the data in the frame.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- This function extracts the data portion of a given valid data frame. A buffer that already has room for the data is
+-- not reallocated.
+-----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::getDataFromFrame(const ByteView& frame, QByteArray& data)
+{
+	data.resize(frame.size - DATA_HEADER_SIZE - CRC_LENGTH);
+	memcpy(data.data(), frame.data + DATA_HEADER_SIZE, data.size());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: deliverFrame()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Takes a pointer to the data so it can be read straight out of the frame.
+--					Oct 16, 2026 - Hands a view of the data to every receive sink instead of converting it to text.
+--					Oct 16, 2026 - Delivers every data byte now that frames are not padded.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void deliverFrame(const ByteView& data)
+--						const ByteView& data: The data of the next frame in sequence.
 --
--- RETURNS:			The QString representation of the data in the frame.
+-- RETURNS:			void.
 --
 -- NOTES:
--- This function extracts the data portion of a given valid data frame.
+-- Writes the data of the next in sequence frame to every receive sink and moves the receive window forward by one
+-- frame. The view is only valid during the call, so a sink that keeps the data copies it.
 -----------------------------------------------------------------------------------------------------------------------*/
-QString IOThread::getDataFromFrame(const QByteArray& frame)
+void IOThread::deliverFrame(const ByteView& data)
 {
-	return frame.mid(DATA_HEADER_SIZE, DATA_LENGTH);
+	for (ReceiveSink* sink : mRxSinks)
+	{
+		sink->Write(data);
+	}
+	mRxExpectedSeq++;
 }
 
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: flushReceiveSinks()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void flushReceiveSinks()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called once the delivered frames have been acknowledged. Flushes every receive sink and sends whatever the display
+-- sink collected to the GUI thread as raw bytes. The bytes are only turned into text by the display.
+-----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::flushReceiveSinks()
+{
+	for (ReceiveSink* sink : mRxSinks)
+	{
+		sink->Flush();
+	}
+	if (!mDisplaySink.IsEmpty())
+	{
+		emit DataReceieved(mDisplaySink.Take());
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: releaseRxWindow()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void releaseRxWindow()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Gives the buffers of every out of sequence frame in the receive window back to the frame buffer pool.
+-----------------------------------------------------------------------------------------------------------------------*/
+void IOThread::releaseRxWindow()
+{
+	for (int i = 0; i < MAX_WINDOW_SIZE; i++)
+	{
+		if (mRxWindow[i] != nullptr)
+		{
+			mFramePool.Release(mRxWindow[i]);
+			mRxWindow[i] = nullptr;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: getInt64()
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 getInt64(const ByteView& frame, const int pos)
+--						const ByteView& frame: The frame to read from.
+--						const int pos: The index of the first byte of the number.
+--
+-- RETURNS:			The 64 bit big endian number at pos.
+-----------------------------------------------------------------------------------------------------------------------*/
+qint64 IOThread::getInt64(const ByteView& frame, const int pos)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		value = (value << 8) | (uint8_t)frame[pos + i];
+	}
+	return (qint64)value;
+}
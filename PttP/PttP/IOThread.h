@@ -1,26 +1,39 @@
 #pragma once
 
+#include <atomic>
+#include <cmath>
 #include <cstdint>
 #include <iomanip>
 
 #include <QAction>
 #include <QByteArray>
-#include <QMutex>
+#include <QElapsedTimer>
+#include <QList>
 #include <QObject>
-#include <QSerialPort>
 #include <QString>
 #include <QThread>
-#include <QTime>
+#include <QTimer>
 
 #include "CRC.h"
 
-#include "ByteArrayOperators.h"
+#include "BufferSink.h"
+#include "ByteView.h"
 #include "ControlCharacters.h"
 #include "FileManip.h"
+#include "FramePool.h"
+#include "FramePrefetcher.h"
+#include "FrameParser.h"
+#include "FrameWriter.h"
+#include "ReceiveSink.h"
+#include "RttEstimator.h"
+#include "Transport.h"
 
-#define DATA_FRAME_SIZE 518
-#define DATA_HEADER_SIZE 2
-#define DATA_LENGTH	512
+#define ERROR_RATE_WINDOW	64
+
+#define DEFAULT_WINDOW_SIZE	8
+#define MAX_WINDOW_SIZE		32
+#define MAX_TX_FRAMES		10
+#define FRAME_POOL_SIZE		(3 * MAX_WINDOW_SIZE + PREFETCH_DEPTH + 1)
 
 #define RTS			0x0001
 #define FIN			0x0002
@@ -39,6 +52,8 @@
 
 #define TIMEOUT_LEN 2000
 
+#define WRITE_AHEAD_SIZE	4096
+
 using namespace std;
 
 class IOThread : public QThread
@@ -46,6 +61,12 @@ class IOThread : public QThread
 	Q_OBJECT
 
 public:
+	enum ArqMode
+	{
+		GO_BACK_N,
+		SELECTIVE_REPEAT
+	};
+
 	const static QByteArray SYN_BYTE;
 	const static QByteArray STX_BYTE;
 
@@ -53,12 +74,14 @@ public:
 	const static QByteArray ENQ_FRAME;
 	const static QByteArray EOT_FRAME;
 	const static QByteArray RVI_FRAME;
+	const static QByteArray NAK_FRAME;
 
-	IOThread(QObject *parent);
+	IOThread(QObject *parent, const int windowSize = DEFAULT_WINDOW_SIZE, const ArqMode arqMode = SELECTIVE_REPEAT,
+		const int maxDataLength = DEFAULT_DATA_LENGTH);
 	~IOThread();
 
 	/*-------------------------------------------------------------------------------------------------
-	-- FUNCTION: GetPort()
+	-- FUNCTION: GetFileManip()
 	--
 	-- DATE: November 29, 2017
 	--
@@ -68,19 +91,19 @@ public:
 	--
 	-- PROGRAMMER: Benny Wang
 	--
-	-- INTERFACE: QSerialPort* GetPort (void)
+	-- INTERFACE: FileManip* GetFileManip (void)
 	--
-	-- RETURNS: A pointer to the QSerialPort.
+	-- RETURNS: A pointer to the File Manipulator.
 	--
 	-- NOTES:
-	-- Getter function for the pointer to the programs QSerialPort.
+	-- Getter function for the pointer to the programs File manipulator.
 	-------------------------------------------------------------------------------------------------*/
-	inline QSerialPort* GetPort() const { return mPort; }
+	inline FileManip* GetFileManip() const { return mFile; }
 
 	/*-------------------------------------------------------------------------------------------------
-	-- FUNCTION: GetFileManip()
+	-- FUNCTION: GetFramePool()
 	--
-	-- DATE: November 29, 2017
+	-- DATE: Oct 16, 2026
 	--
 	-- REVISIONS: N/A
 	--
@@ -88,67 +111,147 @@ public:
 	--
 	-- PROGRAMMER: Benny Wang
 	--
-	-- INTERFACE: FileManip* GetFileManip (void)
+	-- INTERFACE: const FramePool& GetFramePool (void)
 	--
-	-- RETURNS: A pointer to the File Manipulator.
+	-- RETURNS: A reference to the pool of frame buffers.
 	--
 	-- NOTES:
-	-- Getter function for the pointer to the programs File manipulator.
+	-- Getter function for the frame buffer pool so its size and usage can be displayed.
 	-------------------------------------------------------------------------------------------------*/
-	inline FileManip* GetFileManip() const { return mFile; }
+	inline const FramePool& GetFramePool() const { return mFramePool; }
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetWriteQueueDepth()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetWriteQueueDepth (void)
+	--
+	-- RETURNS: The number of bytes waiting to be written, in the write queue and in the port.
+	--
+	-- NOTES:
+	-- Can be called from any thread. The number is updated whenever bytes are queued or written.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetWriteQueueDepth() const { return mWriteQueueDepth.load(); }
+
+	void AddReceiveSink(ReceiveSink* sink);
+	void OpenPort(const QString& name);
 
 protected:
 	void run();
 
 private:
 	bool mRunning;
-	uint32_t mFlags;
+	atomic<uint32_t> mFlags;
 
+	Transport* mPort;
+	QTimer* mTimer;
+	QObject mRequests;
 	FileManip* mFile;
-	QSerialPort* mPort;
-	QMutex mMutex;
+	FramePrefetcher* mPrefetcher;
 
-	QByteArray mBuffer;
-	QString mFrameData;
+	atomic<bool> mEventPending;
+	QByteArray mTxQueue;
+	int mTxQueueHead;
+	atomic<int> mWriteQueueDepth;
+
+	FrameParser mParser;
+	FrameWriter mFrameWriter;
+	FramePool mFramePool;
+	BufferSink mDisplaySink;
+	QList<ReceiveSink*> mRxSinks;
 	int mTxFrameCount;
 	int mRTXCount;
+
+	int mWindowSize;
+	ArqMode mArqMode;
+	int mMaxDataLength;
+	int mTxDataLimit;
+	int mTxDataLength;
+	int mRxDataLength;
+	double mTxLostFrames;
+	double mTxBytesSent;
+	uint8_t mTxBase;
+	int mTxSent;
+	uint32_t mTxAcked;
+	bool mTxEndOfFile;
+	QList<PreparedFrame> mTxWindow;
+	QList<qint64> mTxSentAt;
+	qint64 mTxEnqSentAt;
+	RttEstimator mTxRtt;
+	uint8_t mRxExpectedSeq;
+	uint32_t mRxReceived;
+	QByteArray* mRxWindow[MAX_WINDOW_SIZE];
+	qint64 mRxAckSentAt;
+	RttEstimator mRxRtt;
+	int mRxPeerTimeout;
 	double byteError;
 	double byteValid;
-	QTime mTimeout;
+	QElapsedTimer mClock;
+	qint64 mTimeout;
 
 
 	void setFlag(const uint32_t flag, const bool state);
+	void updateFlags(const uint32_t set, const uint32_t clear);
 	bool isFlagSet(const uint32_t flag);
+	uint32_t getFlags();
 
-	void startTimeout(const int ms);
+	void postEvent();
+	void handleEvents();
+	void processState();
+	void openFile(const QString& name);
+
+	void startTimeout(const int ms, const bool addJitter = true);
 	void updateTimeout();
 
 	void sendACK();
 	void sendENQ();
 	void sendEOT();
 	void sendRVI();
+	void sendNAK(const uint8_t seq);
 	void sendFrame();
 	void resendFrame();
 	void resetFlags();
 	void resetFlagsNoTimeout();
 	void backoff();
-	QByteArray makeFrame(const QByteArray& data);
+	void recordFrameOutcome(const int dataLength, const bool lost);
+	void adaptDataLength();
 
 	void handleBuffer();
-	void checkPotentialDataFrame();
+	void handleACK(const uint8_t seq, const uint16_t dataLength, const uint32_t received);
+	void handleNAK(const uint8_t seq);
+	void checkPotentialDataFrame(const ByteView& dataFrame);
+
+	bool isDataFrameValid(const ByteView& frame);
+	bool isControlFrameValid(const ByteView& frame);
+	int getReceiveTimeout() const;
+	void getDataFromFrame(const ByteView& frame, QByteArray& data);
+	void deliverFrame(const ByteView& data);
+	void flushReceiveSinks();
+	void releaseRxWindow();
+	qint64 getInt64(const ByteView& frame, const int pos);
 
-	bool isDataFrameValid(const QByteArray& frame);
-	QString getDataFromFrame(const QByteArray& frame);
+	void GetDataFromPort();
+	void openPort(const QString& name);
+	void createPort(const QString& name);
+	void drainWriteQueue();
 
 public slots:
 	void SendFile();
 	void SetRVI();
-	void GetDataFromPort();
 	void SetPort();
 	void writeToPort(const QByteArray& frame);
 
 signals:
-	void DataReceieved(const QString data);
-	void writeToPortSignal(const QByteArray& frame);
+	void DataReceieved(const QByteArray data);
+	void eventPosted();
+	void portSelected(const QString name);
 	void UpdateLabel(const QString str);
+	void FileOpened(const qint64 size);
 };
@@ -0,0 +1,513 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LoopbackTransport.cpp - A transport that is one end of a pipe inside the program.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- LoopbackTransport(QObject* parent)
+-- ~LoopbackTransport()
+-- void SetTamper(const QString& name, const LoopbackTamper& tamper)
+-- bool Open(const QString& name)
+-- void Close()
+-- bool IsOpen()
+-- qint64 Read(char* data, const qint64 maxLength)
+-- qint64 Write(const char* data, const qint64 length)
+-- qint64 BytesToWrite()
+-- QString ErrorString()
+-- void transfer(LoopbackLink& link, const int side)
+-- void reportReadable()
+-- void reportWritten()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 17, 2026 - Holds at most LOOPBACK_CAPACITY unread bytes, so a writer has to wait for its reader.
+--            Oct 17, 2026 - Lets a test damage the bytes going through a pipe.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Opening a port named LOOPBACK_PREFIX followed by any name, such as loopback:bench, makes one end of a pipe. The
+-- next transport opened with the same name becomes the other end. Two I/O threads in the same program can then run
+-- the whole protocol against each other with nothing in between but a copy into memory, which shows where the
+-- program itself spends its time.
+--
+-- LoopbackDriver does this to send a file from one I/O thread to another without a serial port or a window.
+--
+-- The pipe holds at most LOOPBACK_CAPACITY bytes that the other end has not read yet, like the buffer of a tty. What
+-- does not fit waits in this end until the other end reads, and is counted by BytesToWrite, so a writer that is
+-- faster than its reader is held back the same way a serial port holds it back. bytesWritten is emitted once bytes
+-- are in the pipe.
+--
+-- A tamper function can be set for a name before the pipe is opened, and is handed every byte as it goes into the
+-- pipe, so a test can damage the bytes the way noise on a serial line would.
+--
+-- Bytes written before the other end is opened wait for it. Bytes written after it is closed are dropped, as on a
+-- wire with nobody at the other end. Each end is told there is something to read, or that its bytes went into the
+-- pipe, from its own event loop, so the two ends can run on different threads.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "LoopbackTransport.h"
+
+#include <cstring>
+
+#include <QHash>
+#include <QMutexLocker>
+#include <QTimer>
+
+static QMutex waitingMutex;
+static QHash<QString, LoopbackTransport*> waiting;
+static QHash<QString, LoopbackTamper> tampers;
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LoopbackTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		LoopbackTransport (QObject* parent)
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Nothing is connected until the port is opened.
+----------------------------------------------------------------------------------------------------------------------*/
+LoopbackTransport::LoopbackTransport(QObject* parent)
+	: Transport(parent)
+	, mSide(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~LoopbackTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~LoopbackTransport (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Deconstructor. Closes this end, so a transport opened later with the same name will not be paired with it.
+----------------------------------------------------------------------------------------------------------------------*/
+LoopbackTransport::~LoopbackTransport()
+{
+	Close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SetTamper
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void SetTamper (const QString& name, const LoopbackTamper& tamper)
+--						const QString& name: LOOPBACK_PREFIX followed by the name of the pipe.
+--						const LoopbackTamper& tamper: The function to hand the bytes to, or an empty one for none.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Sets the function that is handed the bytes going through the pipe with this name, for a pipe that is opened after
+-- this call. It is called with the side that wrote the bytes, 0 for the end that was opened first, and may change
+-- them where they are.
+--
+-- It is called with the pipe locked, from whichever thread is moving the bytes, so it is never called twice at once
+-- for one pipe and sees the bytes of each side in the order they were written. It must not call the transports.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::SetTamper(const QString& name, const LoopbackTamper& tamper)
+{
+	QMutexLocker locker(&waitingMutex);
+	if (tamper)
+	{
+		tampers.insert(name, tamper);
+	}
+	else
+	{
+		tampers.remove(name);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Passes on what was written before the other end was opened.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool Open (const QString& name)
+--						const QString& name: LOOPBACK_PREFIX followed by the name of the pipe.
+--
+-- RETURNS:			True.
+--
+-- NOTES:
+-- Becomes the other end of the pipe an earlier transport opened with this name, or makes a new pipe and waits for
+-- one. When both ends are there, this end is told to read whatever was already written to it, and the other end is
+-- told how much of what it wrote went into the pipe.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackTransport::Open(const QString& name)
+{
+	Close();
+
+	QMutexLocker locker(&waitingMutex);
+	LoopbackTransport* peer = waiting.take(name);
+	if (peer == nullptr)
+	{
+		mLink = make_shared<LoopbackLink>();
+		mName = name;
+		mSide = 0;
+		mLink->end[0] = this;
+		mLink->tamper = tampers.value(name);
+		waiting.insert(name, this);
+		return true;
+	}
+
+	mLink = peer->mLink;
+	mSide = 1;
+	QMutexLocker linkLocker(&mLink->mutex);
+	mLink->end[1] = this;
+	transfer(*mLink, 0);
+	if (mLink->inbox[1].size() > mLink->head[1] && !mLink->readQueued[1])
+	{
+		mLink->readQueued[1] = true;
+		QTimer::singleShot(0, this, [this] { reportReadable(); });
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Drops what did not fit in the pipe.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Close (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Leaves the pipe. The other end can still read what is in the pipe, but anything it writes from now on is dropped.
+-- What did not fit in the pipe yet is dropped as well.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::Close()
+{
+	{
+		QMutexLocker locker(&waitingMutex);
+		if (waiting.value(mName) == this)
+		{
+			waiting.remove(mName);
+		}
+	}
+
+	if (mLink)
+	{
+		QMutexLocker locker(&mLink->mutex);
+		mLink->end[mSide] = nullptr;
+		mLink->outbox[mSide].clear();
+		mLink->closed = true;
+	}
+
+	mLink.reset();
+	mName.clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: IsOpen
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool IsOpen (void)
+--
+-- RETURNS:			True if this end is open, even if the other end is not, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackTransport::IsOpen() const
+{
+	return mLink != nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Makes room in the pipe for what the other end is waiting to write.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Read (char* data, const qint64 maxLength)
+--						char* data: Where to put the bytes.
+--						const qint64 maxLength: The most bytes to read.
+--
+-- RETURNS:			The number of bytes read, 0 if none have arrived or -1 if this end is not open.
+--
+-- NOTES:
+-- Whatever the other end could not fit in the pipe is moved into the room that was made, and the other end is told
+-- it was written.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 LoopbackTransport::Read(char* data, const qint64 maxLength)
+{
+	if (!mLink)
+	{
+		return -1;
+	}
+
+	QMutexLocker locker(&mLink->mutex);
+	QByteArray& inbox = mLink->inbox[mSide];
+	int& head = mLink->head[mSide];
+
+	int length = (int)qMin((qint64)(inbox.size() - head), maxLength);
+	memcpy(data, inbox.constData() + head, length);
+	head += length;
+	if (head == inbox.size() || head >= LOOPBACK_CAPACITY)
+	{
+		inbox.remove(0, head);
+		head = 0;
+	}
+	transfer(*mLink, 1 - mSide);
+	return length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Keeps what does not fit in the pipe until the other end reads.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Write (const char* data, const qint64 length)
+--						const char* data: The bytes to write.
+--						const qint64 length: The number of bytes to write.
+--
+-- RETURNS:			The number of bytes taken, or -1 if this end is not open.
+--
+-- NOTES:
+-- Takes every byte and puts as many as fit in the pipe, keeping the rest until the other end reads. bytesWritten is
+-- emitted for the bytes that went into the pipe once control is back in the event loop, never from inside this call.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 LoopbackTransport::Write(const char* data, const qint64 length)
+{
+	if (!mLink)
+	{
+		return -1;
+	}
+
+	QMutexLocker locker(&mLink->mutex);
+	if (!mLink->closed)
+	{
+		mLink->outbox[mSide].append(data, (int)length);
+		transfer(*mLink, mSide);
+	}
+	return length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: BytesToWrite
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Counts the bytes that did not fit in the pipe.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 BytesToWrite (void)
+--
+-- RETURNS:			The number of bytes that are waiting for room in the pipe, or 0 once the other end is closed.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 LoopbackTransport::BytesToWrite() const
+{
+	if (!mLink)
+	{
+		return 0;
+	}
+
+	QMutexLocker locker(&mLink->mutex);
+	return mLink->closed ? 0 : mLink->outbox[mSide].size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ErrorString
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		QString ErrorString (void)
+--
+-- RETURNS:			A description of the last error.
+----------------------------------------------------------------------------------------------------------------------*/
+QString LoopbackTransport::ErrorString() const
+{
+	return IsOpen() ? QString() : QString("loopback not open");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: transfer
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void transfer (LoopbackLink& link, const int side)
+--						LoopbackLink& link: The pipe, which must be locked.
+--						const int side: The end whose waiting bytes are moved.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Moves as many bytes as fit from the end that wrote them into the pipe, handing them to the tamper function if there
+-- is one. If any were moved, the end that wrote them is told they were written and the other end is told there is
+-- something to read.
+--
+-- Each end is told from its own event loop, and only once until it has been told, however many writes and reads
+-- happen before then. An end is only told while it is open, and the call is dropped if it is deleted before then.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::transfer(LoopbackLink& link, const int side)
+{
+	QByteArray& outbox = link.outbox[side];
+	QByteArray& inbox = link.inbox[1 - side];
+	int room = LOOPBACK_CAPACITY - (inbox.size() - link.head[1 - side]);
+	int length = qMin(room, outbox.size());
+	if (length <= 0)
+	{
+		return;
+	}
+
+	inbox.append(outbox.constData(), length);
+	outbox.remove(0, length);
+	if (link.tamper)
+	{
+		link.tamper(side, inbox.data() + inbox.size() - length, length);
+	}
+	link.written[side] += length;
+
+	LoopbackTransport* writer = link.end[side];
+	if (writer != nullptr && !link.writtenQueued[side])
+	{
+		link.writtenQueued[side] = true;
+		QTimer::singleShot(0, writer, [writer] { writer->reportWritten(); });
+	}
+	LoopbackTransport* reader = link.end[1 - side];
+	if (reader != nullptr && !link.readQueued[1 - side])
+	{
+		link.readQueued[1 - side] = true;
+		QTimer::singleShot(0, reader, [reader] { reader->reportReadable(); });
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: reportReadable
+--
+-- DATE:			Oct 17, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void reportReadable (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called from the event loop after bytes went into the pipe for this end. Emits readyRead once for all of them.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::reportReadable()
+{
+	if (!mLink)
+	{
+		return;
+	}
+
+	{
+		QMutexLocker locker(&mLink->mutex);
+		mLink->readQueued[mSide] = false;
+	}
+	emit readyRead();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: reportWritten
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Reports the bytes that went into the pipe, which may be after a read by the other end.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void reportWritten (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called from the event loop after bytes this end wrote went into the pipe. Emits bytesWritten once for all of them.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::reportWritten()
+{
+	if (!mLink)
+	{
+		return;
+	}
+
+	qint64 written;
+	{
+		QMutexLocker locker(&mLink->mutex);
+		written = mLink->written[mSide];
+		mLink->written[mSide] = 0;
+		mLink->writtenQueued[mSide] = false;
+	}
+	if (written > 0)
+	{
+		emit bytesWritten(written);
+	}
+}
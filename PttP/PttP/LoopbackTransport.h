@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QByteArray>
+#include <QMutex>
+
+#include "Transport.h"
+
+#define LOOPBACK_PREFIX		"loopback:"
+#define LOOPBACK_CAPACITY	(1 << 16)
+
+using namespace std;
+
+typedef function<void(const int side, char* data, const int length)> LoopbackTamper;
+
+class LoopbackTransport;
+
+struct LoopbackLink
+{
+	QMutex mutex;
+	QByteArray inbox[2];
+	int head[2];
+	QByteArray outbox[2];
+	LoopbackTransport* end[2];
+	qint64 written[2];
+	bool readQueued[2];
+	bool writtenQueued[2];
+	bool closed;
+	LoopbackTamper tamper;
+
+	LoopbackLink()
+		: head{ 0, 0 }
+		, end{ nullptr, nullptr }
+		, written{ 0, 0 }
+		, readQueued{ false, false }
+		, writtenQueued{ false, false }
+		, closed(false)
+	{}
+};
+
+class LoopbackTransport : public Transport
+{
+public:
+	LoopbackTransport(QObject* parent = nullptr);
+	~LoopbackTransport();
+
+	static void SetTamper(const QString& name, const LoopbackTamper& tamper);
+
+	bool Open(const QString& name) override;
+	void Close() override;
+	bool IsOpen() const override;
+	qint64 Read(char* data, const qint64 maxLength) override;
+	qint64 Write(const char* data, const qint64 length) override;
+	qint64 BytesToWrite() const override;
+	QString ErrorString() const override;
+
+private:
+	shared_ptr<LoopbackLink> mLink;
+	QString mName;
+	int mSide;
+
+	static void transfer(LoopbackLink& link, const int side);
+	void reportReadable();
+	void reportWritten();
+};
@@ -7,7 +7,7 @@
 -- PttP::PttP(QWidget *parent);
 -- void PttP::populatePortMenu();
 -- void PttP::SetFileName(const string newFileName);
--- void PttP::DisplayDataFromPort(const QString data);
+-- void PttP::DisplayDataFromPort(const QByteArray data);
 -- void PttP::UpdateLabel(const QString text);
 --
 -- DATE: Nov 29, 2017
@@ -33,7 +33,7 @@ using namespace std;
 --
 -- DATE: November 29, 2017
 --
--- REVISIONS: N/A
+-- REVISIONS: Oct 16, 2026 - Saves received files to disk through a file sink.
 --
 -- DESIGNER: Benny Wang
 --
@@ -47,10 +47,12 @@ using namespace std;
 -- NOTES:
 -- Initializes the main gui window for the application. Creates a file selector and allows users to select a port. 
 -- Port list is populated dynamically. Connects the UI signals to the IOThread to generate start and RVI signals.
+-- Received files are saved as RECEIVE_FILE_NAME in the working directory as well as displayed.
 -------------------------------------------------------------------------------------------------*/
 PttP::PttP(QWidget *parent)
 	: QMainWindow(parent)
 	, mIOThread(new IOThread(this))
+	, mFileSink(new FileSink(RECEIVE_FILE_NAME, this))
 {
 	ui.setupUi(this);
 
@@ -75,6 +77,8 @@ PttP::PttP(QWidget *parent)
 	// Updates the label on UI
 	connect(mIOThread, SIGNAL(UpdateLabel(QString)), this, SLOT(UpdateLabel(QString)));
 
+	mIOThread->AddReceiveSink(mFileSink);
+	mFileSink->start();
 	mIOThread->start();
 }
 
@@ -83,7 +87,7 @@ PttP::PttP(QWidget *parent)
 --
 -- DATE: November 29, 2017
 --
--- REVISIONS: N/A
+-- REVISIONS: Oct 16, 2026 - Also lists a pty pair on Linux and the ports named in EXTRA_PORTS_VARIABLE.
 --
 -- DESIGNER: Benny Wang
 --
@@ -95,10 +99,21 @@ PttP::PttP(QWidget *parent)
 --
 -- NOTES:
 -- Populates the port menu in the menu bar with a list of all available serial ports on the system.
+-- On Linux a new pty pair can be picked as well. EXTRA_PORTS_VARIABLE can hold more port names separated by commas,
+-- such as unix:/tmp/pttp.sock, for links that are not serial ports.
 -------------------------------------------------------------------------------------------------*/
 void PttP::populatePortMenu()
 {
-	QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+	QStringList ports;
+	for (const QSerialPortInfo& info : QSerialPortInfo::availablePorts())
+	{
+		ports.append(info.portName());
+	}
+#ifdef Q_OS_LINUX
+	ports.append(PTY_PORT_NAME);
+#endif
+	ports.append(QString::fromLocal8Bit(qgetenv(EXTRA_PORTS_VARIABLE)).split(',', QString::SkipEmptyParts));
+
 	if (ports.size() == 0)
 	{
 		ui.menuPorts->setEnabled(false);
@@ -110,8 +125,8 @@ void PttP::populatePortMenu()
 	for (int i = 0; i < ports.size(); i++)
 	{
 		action = new QAction(this);
-		action->setObjectName(ports[i].portName());
-		action->setText(ports[i].portName());
+		action->setObjectName(ports[i]);
+		action->setText(ports[i]);
 
 		ui.menuPorts->addAction(action);
 
@@ -148,29 +163,31 @@ void PttP::SetFileName(const string newFileName)
 --
 -- DATE: November 30, 2017
 --
--- REVISIONS: N/A
+-- REVISIONS: Oct 16, 2026 - Is given the raw bytes and turns them into text itself.
 --
 -- DESIGNER: Benny Wang
 --
 -- PROGRAMMER: Benny Wang
 --
--- INTERFACE: void DisplayDataFromPort (string data)
---		string data: The data that was unpacked from a valid data frame.
+-- INTERFACE: void DisplayDataFromPort (const QByteArray data)
+--		const QByteArray data: The data that was unpacked from valid data frames.
 --
 -- RETURNS: void.
 --
 -- NOTES:
 -- This is a Qt Slot.
 -- When a valid data frame is received and the data is extracted, the function extracting the data
--- will emit a signal containing the std::string representation of that data and this function will
+-- will emit a signal containing that data and this function will
 -- take that data and display it.
+--
+-- The data arrives as the bytes that were received. It is only decoded as UTF-8 text here, for display.
 -------------------------------------------------------------------------------------------------*/
-void PttP::DisplayDataFromPort(const QString data)
+void PttP::DisplayDataFromPort(const QByteArray data)
 {
 	QPlainTextEdit* textEdit = ui.plainTextEdit;
 	QScrollBar* scrollBar = textEdit->verticalScrollBar();
 
-	textEdit->insertPlainText(data);
+	textEdit->insertPlainText(QString::fromUtf8(data));
 	scrollBar->setValue(scrollBar->maximum());
 }
 
@@ -5,12 +5,17 @@
 #include <QtWidgets/QMainWindow>
 #include <QScrollBar>
 #include <QSerialPortInfo>
+#include <QStringList>
 #include <QPlainTextEdit>
 
 #include "FileManip.h"
+#include "FileSink.h"
 #include "IOThread.h"
+#include "PtyTransport.h"
 #include "ui_PttP.h"
 
+#define EXTRA_PORTS_VARIABLE	"PTTP_PORTS"
+
 using namespace std;
 
 class PttP : public QMainWindow
@@ -24,6 +29,7 @@ private:
 	Ui::PttPClass ui;
 
 	IOThread* mIOThread;
+	FileSink* mFileSink;
 
 	/*-------------------------------------------------------------------------------------------------
 	-- FUNCTION: populatePortMenu()
@@ -51,7 +57,7 @@ private:
 	public slots:
 	void SetFileName(const string newFileName);
 
-	void DisplayDataFromPort(const QString data);
+	void DisplayDataFromPort(const QByteArray data);
 
 	void UpdateLabel(const QString str);
 };
@@ -0,0 +1,53 @@
+# The protocol, the transports and the file handling, without the main window. Included by every program that is
+# built from these sources.
+#
+# Options, given to qmake as CONFIG+=<option>:
+#   qserialport  Talk to the tty through QSerialPort on Linux instead of TermiosTransport.
+
+QT += core gui widgets serialport
+CONFIG += c++14
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+	$$PWD/BufferSink.cpp \
+	$$PWD/FileManip.cpp \
+	$$PWD/FileSink.cpp \
+	$$PWD/FrameParser.cpp \
+	$$PWD/FramePool.cpp \
+	$$PWD/FramePrefetcher.cpp \
+	$$PWD/FrameWriter.cpp \
+	$$PWD/IOThread.cpp \
+	$$PWD/LoopbackTransport.cpp \
+	$$PWD/PtyTransport.cpp \
+	$$PWD/RttEstimator.cpp \
+	$$PWD/SerialPortTransport.cpp \
+	$$PWD/TermiosTransport.cpp \
+	$$PWD/Transport.cpp \
+	$$PWD/UnixSocketTransport.cpp
+
+HEADERS += \
+	$$PWD/BufferSink.h \
+	$$PWD/ByteView.h \
+	$$PWD/ControlCharacters.h \
+	$$PWD/CRC.h \
+	$$PWD/FileManip.h \
+	$$PWD/FileSink.h \
+	$$PWD/FrameParser.h \
+	$$PWD/FramePool.h \
+	$$PWD/FramePrefetcher.h \
+	$$PWD/FrameWriter.h \
+	$$PWD/IOThread.h \
+	$$PWD/LoopbackTransport.h \
+	$$PWD/PtyTransport.h \
+	$$PWD/ReceiveSink.h \
+	$$PWD/RttEstimator.h \
+	$$PWD/SerialPortTransport.h \
+	$$PWD/TermiosTransport.h \
+	$$PWD/Transport.h \
+	$$PWD/UnixSocketTransport.h
+
+qserialport {
+	DEFINES += PTTP_USE_QSERIALPORT
+}
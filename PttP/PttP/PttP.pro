@@ -0,0 +1,23 @@
+# The PttP program. The Visual Studio project builds it on Windows; this builds it anywhere else with
+#
+#   qmake && make
+#
+# See PttP.pri for the options.
+
+TEMPLATE = app
+TARGET = PttP
+
+include(PttP.pri)
+
+SOURCES += \
+	main.cpp \
+	PttP.cpp
+
+HEADERS += \
+	PttP.h
+
+FORMS += \
+	PttP.ui
+
+RESOURCES += \
+	PttP.qrc
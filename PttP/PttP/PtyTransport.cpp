@@ -0,0 +1,172 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PtyTransport.cpp - A transport that makes a new Linux pty pair and talks through its master side.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- PtyTransport(QObject* parent)
+-- ~PtyTransport()
+-- bool Open(const QString& name)
+-- void Close()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Selecting the port named PTY_PORT_NAME makes a new pty pair and prints the path of its other side, such as
+-- /dev/pts/3. A second copy of the program then selects that path as its port, which it opens like any other tty, and
+-- the two can run the whole protocol on a machine with no serial ports. A pty is not held to a baud rate, so it also
+-- shows how fast the program itself can go.
+--
+-- Reading and writing are done by TermiosTransport.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "PtyTransport.h"
+
+#ifdef Q_OS_LINUX
+
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <QDebug>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PtyTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		PtyTransport (QObject* parent)
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Nothing is made until the port is opened.
+----------------------------------------------------------------------------------------------------------------------*/
+PtyTransport::PtyTransport(QObject* parent)
+	: TermiosTransport(parent)
+	, mPeerFd(-1)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~PtyTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~PtyTransport (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Deconstructor. Closes both sides of the pty.
+----------------------------------------------------------------------------------------------------------------------*/
+PtyTransport::~PtyTransport()
+{
+	Close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool Open (const QString& name)
+--						const QString& name: PTY_PORT_NAME. It is not used otherwise.
+--
+-- RETURNS:			True if the pty was made and set up, otherwise false.
+--
+-- NOTES:
+-- Makes a new pty pair and puts it in raw mode. The settings made on the master side apply to the other side, so
+-- the program that opens it reads exactly the bytes written here.
+--
+-- The other side is kept open here as well. Otherwise the master would report a hang up over and over until the
+-- other program opens it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PtyTransport::Open(const QString& name)
+{
+	Q_UNUSED(name);
+	Close();
+
+	mFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (mFd < 0 || grantpt(mFd) != 0 || unlockpt(mFd) != 0)
+	{
+		setError("posix_openpt");
+		Close();
+		return false;
+	}
+
+	const char* peer = ptsname(mFd);
+	mPeerFd = peer != nullptr ? ::open(peer, O_RDWR | O_NOCTTY | O_CLOEXEC) : -1;
+	if (mPeerFd < 0)
+	{
+		setError("open pty");
+		Close();
+		return false;
+	}
+
+	if (!configure())
+	{
+		Close();
+		return false;
+	}
+
+	attach();
+	qDebug() << "pty ready, open" << peer << "on the other side";
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Close (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Closes both sides of the pty. The program on the other side sees a hang up.
+----------------------------------------------------------------------------------------------------------------------*/
+void PtyTransport::Close()
+{
+	TermiosTransport::Close();
+
+	if (mPeerFd >= 0)
+	{
+		::close(mPeerFd);
+		mPeerFd = -1;
+	}
+}
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+
+#include "TermiosTransport.h"
+
+#define PTY_PORT_NAME	"pty"
+
+class PtyTransport : public TermiosTransport
+{
+public:
+	PtyTransport(QObject* parent = nullptr);
+	~PtyTransport();
+
+	bool Open(const QString& name) override;
+	void Close() override;
+
+private:
+	int mPeerFd;
+};
+
+#endif
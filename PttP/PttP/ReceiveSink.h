@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ByteView.h"
+
+/*-------------------------------------------------------------------------------------------------
+-- CLASS: ReceiveSink
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 16, 2026 - Added Start and Finish for sinks that save a whole file.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Something that takes the data of received frames, in order. The protocol thread calls Write
+-- with a view straight into the received frame, which is only valid until Write returns. Flush is
+-- called once the frames that were written have been acknowledged.
+--
+-- Start is called for every ENQ with the size of the file the sender is sending and the offset in
+-- it of the next frame, and Finish is called for every EOT.
+-------------------------------------------------------------------------------------------------*/
+class ReceiveSink
+{
+public:
+	virtual ~ReceiveSink() {}
+
+	virtual void Start(const qint64 size, const qint64 offset) {}
+	virtual void Write(const ByteView& data) = 0;
+	virtual void Flush() {}
+	virtual void Finish() {}
+};
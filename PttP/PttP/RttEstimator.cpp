@@ -0,0 +1,145 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RttEstimator.cpp - Works out retransmission timeouts from measured round trip times.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- RttEstimator(const int initialTimeout)
+-- void AddSample(const int64_t ms)
+-- void Backoff()
+-- void Reset()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Keeps a smoothed mean and variance of round trip time samples and turns them into a timeout the same way TCP does
+-- (RFC 6298). Until the first sample arrives the initial timeout is used.
+--
+-- Samples must only come from frames that were sent once, otherwise there is no way to tell which copy was answered.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "RttEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: RttEstimator
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		RttEstimator (const int initialTimeout)
+--						const int initialTimeout: The timeout in milliseconds to use before there are any samples.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Starts without any samples.
+----------------------------------------------------------------------------------------------------------------------*/
+RttEstimator::RttEstimator(const int initialTimeout)
+	: mInitialTimeout(initialTimeout)
+{
+	Reset();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AddSample
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void AddSample (const int64_t ms)
+--						const int64_t ms: A measured round trip time in milliseconds.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Folds a new sample into the smoothed round trip time and its variance and recalculates the timeout as the smoothed
+-- round trip time plus four times the variance. The timeout is kept between MIN_TIMEOUT_LEN and MAX_TIMEOUT_LEN.
+--
+-- A new sample also undoes any back off.
+----------------------------------------------------------------------------------------------------------------------*/
+void RttEstimator::AddSample(const int64_t ms)
+{
+	double sample = (double)ms;
+
+	if (!mHasSample)
+	{
+		mSmoothedRtt = sample;
+		mRttVariance = sample / 2;
+		mHasSample = true;
+	}
+	else
+	{
+		mRttVariance = 0.75 * mRttVariance + 0.25 * std::fabs(mSmoothedRtt - sample);
+		mSmoothedRtt = 0.875 * mSmoothedRtt + 0.125 * sample;
+	}
+
+	double timeout = mSmoothedRtt + std::max((double)TIMER_GRANULARITY, 4 * mRttVariance);
+	mTimeout = std::min(std::max((int)std::ceil(timeout), MIN_TIMEOUT_LEN), MAX_TIMEOUT_LEN);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Backoff
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Backoff (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Doubles the timeout after it expired, up to MAX_TIMEOUT_LEN. The doubled timeout is used until the next sample.
+----------------------------------------------------------------------------------------------------------------------*/
+void RttEstimator::Backoff()
+{
+	mTimeout = std::min(mTimeout * 2, MAX_TIMEOUT_LEN);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reset
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A 
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Reset (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Forgets every sample and goes back to the initial timeout. Used when the link changes.
+----------------------------------------------------------------------------------------------------------------------*/
+void RttEstimator::Reset()
+{
+	mHasSample = false;
+	mSmoothedRtt = 0;
+	mRttVariance = 0;
+	mTimeout = mInitialTimeout;
+}
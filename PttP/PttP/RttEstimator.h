@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#define MIN_TIMEOUT_LEN		20
+#define MAX_TIMEOUT_LEN		60000
+#define TIMER_GRANULARITY	10
+
+class RttEstimator
+{
+public:
+	RttEstimator(const int initialTimeout);
+
+	void AddSample(const int64_t ms);
+	void Backoff();
+	void Reset();
+
+	/*-------------------------------------------------------------------------------------------------
+	-- FUNCTION: GetTimeout()
+	--
+	-- DATE: Oct 16, 2026
+	--
+	-- REVISIONS: N/A
+	--
+	-- DESIGNER: Benny Wang
+	--
+	-- PROGRAMMER: Benny Wang
+	--
+	-- INTERFACE: int GetTimeout (void)
+	--
+	-- RETURNS: The current retransmission timeout in milliseconds.
+	-------------------------------------------------------------------------------------------------*/
+	inline int GetTimeout() const { return mTimeout; }
+
+private:
+	int mInitialTimeout;
+	bool mHasSample;
+	double mSmoothedRtt;
+	double mRttVariance;
+	int mTimeout;
+};
@@ -0,0 +1,213 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SerialPortTransport.cpp - A transport that talks to a serial port through QSerialPort.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- SerialPortTransport(QObject* parent)
+-- bool Open(const QString& name)
+-- void Close()
+-- bool IsOpen()
+-- qint64 Read(char* data, const qint64 maxLength)
+-- qint64 Write(const char* data, const qint64 length)
+-- qint64 BytesToWrite()
+-- QString ErrorString()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- The portable transport, used on every platform without a native one. QSerialPort already buffers in both
+-- directions and never blocks, so every call is passed straight through to it.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "SerialPortTransport.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SerialPortTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		SerialPortTransport (QObject* parent)
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Sets the port up for TRANSPORT_BAUD_RATE, 8 data bits, no parity, one stop bit and no flow control,
+-- and passes its signals on.
+----------------------------------------------------------------------------------------------------------------------*/
+SerialPortTransport::SerialPortTransport(QObject* parent)
+	: Transport(parent)
+{
+	mPort.setBaudRate(TRANSPORT_BAUD_RATE);
+	mPort.setDataBits(QSerialPort::Data8);
+	mPort.setParity(QSerialPort::NoParity);
+	mPort.setStopBits(QSerialPort::OneStop);
+	mPort.setFlowControl(QSerialPort::NoFlowControl);
+
+	connect(&mPort, &QSerialPort::readyRead, this, &Transport::readyRead);
+	connect(&mPort, &QSerialPort::bytesWritten, this, &Transport::bytesWritten);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool Open (const QString& name)
+--						const QString& name: The name of the port, as listed by QSerialPortInfo.
+--
+-- RETURNS:			True if the port was opened, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SerialPortTransport::Open(const QString& name)
+{
+	mPort.setPortName(name);
+	return mPort.open(QIODevice::ReadWrite);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Close (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Closes the port. Anything still waiting to be written is dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void SerialPortTransport::Close()
+{
+	mPort.close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: IsOpen
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool IsOpen (void)
+--
+-- RETURNS:			True if the port is open, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SerialPortTransport::IsOpen() const
+{
+	return mPort.isOpen();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Read (char* data, const qint64 maxLength)
+--						char* data: Where to put the bytes.
+--						const qint64 maxLength: The most bytes to read.
+--
+-- RETURNS:			The number of bytes read, 0 if none have arrived or -1 on an error.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 SerialPortTransport::Read(char* data, const qint64 maxLength)
+{
+	return mPort.read(data, maxLength);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Write (const char* data, const qint64 length)
+--						const char* data: The bytes to write.
+--						const qint64 length: The number of bytes to write.
+--
+-- RETURNS:			The number of bytes taken, or -1 on an error.
+--
+-- NOTES:
+-- The bytes are copied into the port's write buffer and written once the port is ready for them.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 SerialPortTransport::Write(const char* data, const qint64 length)
+{
+	return mPort.write(data, length);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: BytesToWrite
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 BytesToWrite (void)
+--
+-- RETURNS:			The number of bytes in the port's write buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 SerialPortTransport::BytesToWrite() const
+{
+	return mPort.bytesToWrite();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ErrorString
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		QString ErrorString (void)
+--
+-- RETURNS:			A description of the last error.
+----------------------------------------------------------------------------------------------------------------------*/
+QString SerialPortTransport::ErrorString() const
+{
+	return mPort.errorString();
+}
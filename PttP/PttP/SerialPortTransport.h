@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QSerialPort>
+
+#include "Transport.h"
+
+class SerialPortTransport : public Transport
+{
+public:
+	SerialPortTransport(QObject* parent = nullptr);
+
+	bool Open(const QString& name) override;
+	void Close() override;
+	bool IsOpen() const override;
+	qint64 Read(char* data, const qint64 maxLength) override;
+	qint64 Write(const char* data, const qint64 length) override;
+	qint64 BytesToWrite() const override;
+	QString ErrorString() const override;
+
+private:
+	QSerialPort mPort;
+};
@@ -0,0 +1,568 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: TermiosTransport.cpp - A transport that talks to a Linux tty directly.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- TermiosTransport(QObject* parent)
+-- ~TermiosTransport()
+-- bool Open(const QString& name)
+-- void Close()
+-- bool IsOpen()
+-- qint64 Read(char* data, const qint64 maxLength)
+-- qint64 Write(const char* data, const qint64 length)
+-- qint64 BytesToWrite()
+-- QString ErrorString()
+-- bool configure()
+-- void attach()
+-- ssize_t writeSome(const char* data, const size_t length)
+-- void writePending()
+-- void setError(const QString& what)
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- The transport used on Linux. The tty is opened non-blocking and put in raw mode, and the driver is asked to hand
+-- received bytes over without waiting to collect more. Bytes are read straight into the caller's buffer, which is the
+-- frame parser's ring buffer, in one read for as much as has arrived. Nothing is kept in between and no call is made
+-- to ask how much is waiting first, which QSerialPort does for every read.
+--
+-- The descriptor is watched by the I/O thread's own event loop through a socket notifier, so the thread sleeps until
+-- bytes arrive and wakes up once for every batch of them. Writes go straight to the tty. Whatever it cannot take yet is kept and
+-- written as soon as it has room.
+--
+-- Build with PTTP_USE_QSERIALPORT defined to use QSerialPort on Linux instead.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "TermiosTransport.h"
+
+#ifdef Q_OS_LINUX
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/serial.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <QDebug>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TermiosTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		TermiosTransport (QObject* parent)
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Nothing is opened until a port is selected.
+----------------------------------------------------------------------------------------------------------------------*/
+TermiosTransport::TermiosTransport(QObject* parent)
+	: Transport(parent)
+	, mFd(-1)
+	, mReadNotifier(nullptr)
+	, mWriteNotifier(nullptr)
+	, mPendingHead(0)
+	, mWritten(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~TermiosTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~TermiosTransport (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Deconstructor. Closes the tty.
+----------------------------------------------------------------------------------------------------------------------*/
+TermiosTransport::~TermiosTransport()
+{
+	Close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Watches the tty through attach.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool Open (const QString& name)
+--						const QString& name: The name of the port, as listed by QSerialPortInfo, or a full path.
+--
+-- RETURNS:			True if the tty was opened and set up, otherwise false.
+--
+-- NOTES:
+-- A name without a path is looked for in /dev. The tty does not become the controlling terminal of the program. The
+-- event loop starts watching it for bytes to read once it is set up.
+----------------------------------------------------------------------------------------------------------------------*/
+bool TermiosTransport::Open(const QString& name)
+{
+	Close();
+
+	QString path = name.contains('/') ? name : "/dev/" + name;
+	mFd = ::open(path.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (mFd < 0)
+	{
+		setError("open " + path);
+		return false;
+	}
+
+	if (!configure())
+	{
+		Close();
+		return false;
+	}
+
+	attach();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Close (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Stops watching the tty and closes it. Anything still waiting to be written is dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void TermiosTransport::Close()
+{
+	delete mReadNotifier;
+	delete mWriteNotifier;
+	mReadNotifier = nullptr;
+	mWriteNotifier = nullptr;
+
+	if (mFd >= 0)
+	{
+		::close(mFd);
+		mFd = -1;
+	}
+
+	mPending.resize(0);
+	mPendingHead = 0;
+	mWritten = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: IsOpen
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool IsOpen (void)
+--
+-- RETURNS:			True if the tty is open, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool TermiosTransport::IsOpen() const
+{
+	return mFd >= 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Read (char* data, const qint64 maxLength)
+--						char* data: Where to put the bytes.
+--						const qint64 maxLength: The most bytes to read.
+--
+-- RETURNS:			The number of bytes read, 0 if none have arrived or -1 on an error.
+--
+-- NOTES:
+-- Reads whatever the driver has, up to maxLength, with a single system call that never waits.
+--
+-- A tty that fails, or that has hung up and reads nothing, keeps saying there is something to read. The event loop
+-- stops watching it then, since it would otherwise wake the thread over and over. Since VMIN is 0 a read of nothing
+-- is also what an idle tty gives, so the tty is only taken to have hung up if poll says so.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 TermiosTransport::Read(char* data, const qint64 maxLength)
+{
+	if (mFd < 0)
+	{
+		return -1;
+	}
+
+	ssize_t count = ::read(mFd, data, (size_t)maxLength);
+	if (count < 0)
+	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+		{
+			return 0;
+		}
+		setError("read");
+		mReadNotifier->setEnabled(false);
+		return -1;
+	}
+
+	if (count == 0 && maxLength > 0)
+	{
+		struct pollfd hangup = { mFd, POLLIN, 0 };
+		if (poll(&hangup, 1, 0) > 0 && (hangup.revents & (POLLHUP | POLLERR)))
+		{
+			mError = "hung up";
+			mReadNotifier->setEnabled(false);
+			return -1;
+		}
+	}
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Writes through writeSome.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Write (const char* data, const qint64 length)
+--						const char* data: The bytes to write.
+--						const qint64 length: The number of bytes to write.
+--
+-- RETURNS:			The number of bytes taken, or -1 on an error.
+--
+-- NOTES:
+-- Writes as much as the tty takes right away, unless earlier bytes are still waiting, and keeps the rest. The event
+-- loop is then asked to say when the tty has room, which is where the rest is written and bytesWritten is emitted.
+-- The signal is never emitted from inside this call, so the caller can write again when it gets it.
+--
+-- A write that fails for any reason other than the tty being full keeps none of the bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 TermiosTransport::Write(const char* data, const qint64 length)
+{
+	if (mFd < 0)
+	{
+		return -1;
+	}
+
+	qint64 written = 0;
+	if (mPendingHead == mPending.size())
+	{
+		ssize_t count = writeSome(data, (size_t)length);
+		if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		{
+			setError("write");
+			return -1;
+		}
+		written = qMax((ssize_t)0, count);
+		mWritten += written;
+	}
+
+	mPending.append(data + written, (int)(length - written));
+	mWriteNotifier->setEnabled(true);
+	return length;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: BytesToWrite
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 BytesToWrite (void)
+--
+-- RETURNS:			The number of bytes the tty has not taken yet.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 TermiosTransport::BytesToWrite() const
+{
+	return mPending.size() - mPendingHead;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ErrorString
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		QString ErrorString (void)
+--
+-- RETURNS:			A description of the last error.
+----------------------------------------------------------------------------------------------------------------------*/
+QString TermiosTransport::ErrorString() const
+{
+	return mError;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: configure
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool configure (void)
+--
+-- RETURNS:			True if the tty was set up, otherwise false.
+--
+-- NOTES:
+-- Puts the tty in raw mode at TRANSPORT_BAUD_RATE with 8 data bits, no parity, one stop bit and no flow control, and
+-- throws away anything left in its buffers.
+--
+-- VMIN and VTIME are both 0. The tty is only read once the event loop has seen bytes arrive, so a read should hand
+-- back what is there and never wait for more or for a gap in the line.
+--
+-- ASYNC_LOW_LATENCY tells the driver to pass each received byte on right away instead of collecting them for a few
+-- milliseconds first. Drivers that do not support it, such as most USB adapters and ptys, are left as they are.
+----------------------------------------------------------------------------------------------------------------------*/
+bool TermiosTransport::configure()
+{
+	struct termios options;
+	if (tcgetattr(mFd, &options) != 0)
+	{
+		setError("tcgetattr");
+		return false;
+	}
+
+	cfmakeraw(&options);
+	options.c_cflag |= CLOCAL | CREAD;
+	options.c_cflag &= ~(CSTOPB | CRTSCTS);
+	options.c_cc[VMIN] = 0;
+	options.c_cc[VTIME] = 0;
+
+	speed_t speed;
+	switch (TRANSPORT_BAUD_RATE)
+	{
+	case 19200:
+		speed = B19200;
+		break;
+	case 38400:
+		speed = B38400;
+		break;
+	case 57600:
+		speed = B57600;
+		break;
+	case 115200:
+		speed = B115200;
+		break;
+	default:
+		speed = B9600;
+		break;
+	}
+	cfsetispeed(&options, speed);
+	cfsetospeed(&options, speed);
+
+	if (tcsetattr(mFd, TCSANOW, &options) != 0)
+	{
+		setError("tcsetattr");
+		return false;
+	}
+	tcflush(mFd, TCIOFLUSH);
+
+	struct serial_struct serial;
+	if (ioctl(mFd, TIOCGSERIAL, &serial) == 0)
+	{
+		serial.flags |= ASYNC_LOW_LATENCY;
+		if (ioctl(mFd, TIOCSSERIAL, &serial) != 0)
+		{
+			qDebug() << "low latency mode not supported:" << strerror(errno);
+		}
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: attach
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void attach (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Has the event loop start watching mFd for bytes to read. It only watches for room to write while bytes are
+-- waiting. Works for any non-blocking descriptor, not only a tty.
+----------------------------------------------------------------------------------------------------------------------*/
+void TermiosTransport::attach()
+{
+	mReadNotifier = new QSocketNotifier(mFd, QSocketNotifier::Read, this);
+	mWriteNotifier = new QSocketNotifier(mFd, QSocketNotifier::Write, this);
+	mWriteNotifier->setEnabled(false);
+	connect(mReadNotifier, &QSocketNotifier::activated, this, [this] { emit readyRead(); });
+	connect(mWriteNotifier, &QSocketNotifier::activated, this, [this] { writePending(); });
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: writeSome
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		ssize_t writeSome (const char* data, const size_t length)
+--						const char* data: The bytes to write.
+--						const size_t length: The number of bytes to write.
+--
+-- RETURNS:			The number of bytes written, or -1 with errno set.
+--
+-- NOTES:
+-- A single write to mFd that never waits.
+----------------------------------------------------------------------------------------------------------------------*/
+ssize_t TermiosTransport::writeSome(const char* data, const size_t length)
+{
+	return ::write(mFd, data, length);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: writePending
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Writes through writeSome.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void writePending (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called from the event loop once the tty has room. Writes as many waiting bytes as it takes and reports every byte
+-- written since the last report. The event loop stops watching for room once nothing is waiting.
+--
+-- If the write fails for any reason other than the tty being full, the waiting bytes can never be written, so they
+-- are dropped and the event loop stops watching for room instead of waking the thread over and over.
+----------------------------------------------------------------------------------------------------------------------*/
+void TermiosTransport::writePending()
+{
+	int pending = mPending.size() - mPendingHead;
+	if (pending > 0)
+	{
+		ssize_t count = writeSome(mPending.constData() + mPendingHead, (size_t)pending);
+		if (count > 0)
+		{
+			mPendingHead += (int)count;
+			mWritten += count;
+		}
+		else if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		{
+			setError("write");
+			qDebug() << "dropping" << pending << "bytes after" << mError;
+			mPendingHead = mPending.size();
+		}
+	}
+
+	if (mPendingHead == mPending.size())
+	{
+		mPending.resize(0);
+		mPendingHead = 0;
+		mWriteNotifier->setEnabled(false);
+	}
+
+	if (mWritten > 0)
+	{
+		qint64 written = mWritten;
+		mWritten = 0;
+		emit bytesWritten(written);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: setError
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void setError (const QString& what)
+--						const QString& what: The call that failed.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Keeps a description of the error in errno for ErrorString.
+----------------------------------------------------------------------------------------------------------------------*/
+void TermiosTransport::setError(const QString& what)
+{
+	mError = what + ": " + QString::fromLocal8Bit(strerror(errno));
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+
+#include <sys/types.h>
+
+#include <QByteArray>
+#include <QSocketNotifier>
+
+#include "Transport.h"
+
+class TermiosTransport : public Transport
+{
+public:
+	TermiosTransport(QObject* parent = nullptr);
+	~TermiosTransport();
+
+	bool Open(const QString& name) override;
+	void Close() override;
+	bool IsOpen() const override;
+	qint64 Read(char* data, const qint64 maxLength) override;
+	qint64 Write(const char* data, const qint64 length) override;
+	qint64 BytesToWrite() const override;
+	QString ErrorString() const override;
+
+protected:
+	int mFd;
+	QSocketNotifier* mReadNotifier;
+	QString mError;
+
+	bool configure();
+	void attach();
+	virtual ssize_t writeSome(const char* data, const size_t length);
+	void setError(const QString& what);
+
+private:
+	QSocketNotifier* mWriteNotifier;
+	QByteArray mPending;
+	int mPendingHead;
+	qint64 mWritten;
+
+	void writePending();
+};
+
+#endif
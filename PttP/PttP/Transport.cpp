@@ -0,0 +1,76 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Transport.cpp - Picks the transport the protocol thread uses.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- Transport* Create(const QString& name, QObject* parent)
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Linux talks to the tty directly unless PTTP_USE_QSERIALPORT is defined. Every other platform uses QSerialPort.
+--
+-- A few port names do not name a serial port, so that the protocol can run on a machine that has none:
+-- PTY_PORT_NAME makes a pty pair, UNIX_SOCKET_PREFIX followed by a path connects over a Unix socket, both on Linux
+-- only, and LOOPBACK_PREFIX followed by a name is a pipe between two I/O threads in the same program.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "Transport.h"
+
+#include "LoopbackTransport.h"
+#include "PtyTransport.h"
+#include "SerialPortTransport.h"
+#include "TermiosTransport.h"
+#include "UnixSocketTransport.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Create
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 16, 2026 - Use the io_uring transport when PTTP_USE_IO_URING is defined.
+--					Oct 16, 2026 - Picks the transport by port name.
+--					Oct 17, 2026 - Removed the io_uring transport.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		Transport* Create (const QString& name, QObject* parent)
+--						const QString& name: The name of the port the transport will open.
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			A new transport that is not open yet.
+--
+-- NOTES:
+-- Must be called on the thread that will use the transport.
+----------------------------------------------------------------------------------------------------------------------*/
+Transport* Transport::Create(const QString& name, QObject* parent)
+{
+	if (name.startsWith(LOOPBACK_PREFIX))
+	{
+		return new LoopbackTransport(parent);
+	}
+#ifdef Q_OS_LINUX
+	if (name == PTY_PORT_NAME)
+	{
+		return new PtyTransport(parent);
+	}
+	if (name.startsWith(UNIX_SOCKET_PREFIX))
+	{
+		return new UnixSocketTransport(parent);
+	}
+#endif
+
+#if defined(Q_OS_LINUX) && !defined(PTTP_USE_QSERIALPORT)
+	return new TermiosTransport(parent);
+#else
+	return new SerialPortTransport(parent);
+#endif
+}
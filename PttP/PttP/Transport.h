@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#define TRANSPORT_BAUD_RATE	9600
+
+/*-------------------------------------------------------------------------------------------------
+-- CLASS: Transport
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: Oct 16, 2026 - Create picks the transport by port name.
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- The link the protocol thread reads frames from and writes frames to. A transport is created and
+-- used on the I/O thread only, and never blocks: Read returns what has already arrived and Write
+-- keeps whatever cannot be written yet until the link is ready for it.
+--
+-- readyRead is emitted when there are bytes to read and bytesWritten when bytes that were waiting
+-- have been written, both from the event loop of the I/O thread. Create picks the transport for
+-- a port name: a pty pair, a Unix socket, a pipe inside the program or else the serial port.
+-------------------------------------------------------------------------------------------------*/
+class Transport : public QObject
+{
+	Q_OBJECT
+
+public:
+	Transport(QObject* parent = nullptr) : QObject(parent) {}
+	virtual ~Transport() {}
+
+	static Transport* Create(const QString& name, QObject* parent = nullptr);
+
+	virtual bool Open(const QString& name) = 0;
+	virtual void Close() = 0;
+	virtual bool IsOpen() const = 0;
+	virtual qint64 Read(char* data, const qint64 maxLength) = 0;
+	virtual qint64 Write(const char* data, const qint64 length) = 0;
+	virtual qint64 BytesToWrite() const = 0;
+	virtual QString ErrorString() const = 0;
+
+signals:
+	void readyRead();
+	void bytesWritten(qint64 bytes);
+};
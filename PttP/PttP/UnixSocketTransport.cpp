@@ -0,0 +1,348 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: UnixSocketTransport.cpp - A transport that talks over a Unix domain socket.
+--
+-- PROGRAM: PttP
+--
+-- FUNCTIONS:
+-- UnixSocketTransport(QObject* parent)
+-- ~UnixSocketTransport()
+-- bool Open(const QString& name)
+-- void Close()
+-- qint64 Read(char* data, const qint64 maxLength)
+-- ssize_t writeSome(const char* data, const size_t length)
+-- bool listenOn(const QByteArray& path)
+-- void acceptPeer()
+--
+-- DATE: Oct 16, 2026
+--
+-- REVISIONS: N/A
+--
+-- DESIGNER: Benny Wang
+--
+-- PROGRAMMER: Benny Wang
+--
+-- NOTES:
+-- Selecting a port named UNIX_SOCKET_PREFIX followed by a path, such as unix:/tmp/pttp.sock, connects to the
+-- socket at that path. If nothing is listening there yet, this side listens there instead and takes the first
+-- program that connects. Two copies of the program given the same name end up connected to each other, with no
+-- serial port and no baud rate between them.
+--
+-- Once connected, reading and writing are done by TermiosTransport.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "UnixSocketTransport.h"
+
+#ifdef Q_OS_LINUX
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <QDebug>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: UnixSocketTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		UnixSocketTransport (QObject* parent)
+--						QObject* parent: The parent QObject.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Constructor. Nothing is connected until the port is opened.
+----------------------------------------------------------------------------------------------------------------------*/
+UnixSocketTransport::UnixSocketTransport(QObject* parent)
+	: TermiosTransport(parent)
+	, mListenFd(-1)
+	, mAcceptNotifier(nullptr)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~UnixSocketTransport
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~UnixSocketTransport (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Deconstructor. Closes the connection and stops listening.
+----------------------------------------------------------------------------------------------------------------------*/
+UnixSocketTransport::~UnixSocketTransport()
+{
+	Close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool Open (const QString& name)
+--						const QString& name: UNIX_SOCKET_PREFIX followed by the path of the socket.
+--
+-- RETURNS:			True if this side connected or is listening, otherwise false.
+--
+-- NOTES:
+-- While this side is listening the transport is not open yet, so frames written before the other program connects
+-- are dropped and sent again by the protocol.
+----------------------------------------------------------------------------------------------------------------------*/
+bool UnixSocketTransport::Open(const QString& name)
+{
+	Close();
+
+	QByteArray path = name.mid((int)strlen(UNIX_SOCKET_PREFIX)).toLocal8Bit();
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.isEmpty() || path.size() >= (int)sizeof(address.sun_path))
+	{
+		errno = ENAMETOOLONG;
+		setError("socket path");
+		return false;
+	}
+	memcpy(address.sun_path, path.constData(), path.size());
+
+	mFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (mFd < 0)
+	{
+		setError("socket");
+		return false;
+	}
+
+	if (::connect(mFd, (struct sockaddr*)&address, sizeof(address)) == 0 || errno == EINPROGRESS)
+	{
+		attach();
+		return true;
+	}
+
+	int error = errno;
+	::close(mFd);
+	mFd = -1;
+	if (error != ENOENT && error != ECONNREFUSED)
+	{
+		errno = error;
+		setError("connect " + QString::fromLocal8Bit(path));
+		return false;
+	}
+	return listenOn(path);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void Close (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Closes the connection. If this side was listening, it stops and removes the socket from the file system.
+----------------------------------------------------------------------------------------------------------------------*/
+void UnixSocketTransport::Close()
+{
+	TermiosTransport::Close();
+
+	delete mAcceptNotifier;
+	mAcceptNotifier = nullptr;
+
+	if (mListenFd >= 0)
+	{
+		::close(mListenFd);
+		mListenFd = -1;
+	}
+
+	if (!mPath.isEmpty())
+	{
+		::unlink(mPath.constData());
+		mPath.clear();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		Oct 17, 2026 - Stops watching the socket after an error as well.
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		qint64 Read (char* data, const qint64 maxLength)
+--						char* data: Where to put the bytes.
+--						const qint64 maxLength: The most bytes to read.
+--
+-- RETURNS:			The number of bytes read, 0 if none have arrived or -1 on an error.
+--
+-- NOTES:
+-- A socket, unlike a tty, reads nothing once the other program has gone away. The event loop stops watching it
+-- then, or after any other error, since it would otherwise say there is something to read over and over.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 UnixSocketTransport::Read(char* data, const qint64 maxLength)
+{
+	if (mFd < 0)
+	{
+		return -1;
+	}
+
+	ssize_t count = ::recv(mFd, data, (size_t)maxLength, 0);
+	if (count < 0)
+	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+		{
+			return 0;
+		}
+		setError("read");
+		mReadNotifier->setEnabled(false);
+		return -1;
+	}
+
+	if (count == 0 && maxLength > 0)
+	{
+		mError = "connection closed";
+		mReadNotifier->setEnabled(false);
+		return -1;
+	}
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: writeSome
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		ssize_t writeSome (const char* data, const size_t length)
+--						const char* data: The bytes to write.
+--						const size_t length: The number of bytes to write.
+--
+-- RETURNS:			The number of bytes written, or -1 with errno set.
+--
+-- NOTES:
+-- Writing to a socket the other program has closed fails with EPIPE instead of raising SIGPIPE, which would end
+-- this program.
+----------------------------------------------------------------------------------------------------------------------*/
+ssize_t UnixSocketTransport::writeSome(const char* data, const size_t length)
+{
+	return ::send(mFd, data, length, MSG_NOSIGNAL);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: listenOn
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		bool listenOn (const QByteArray& path)
+--						const QByteArray& path: The path of the socket.
+--
+-- RETURNS:			True if this side is listening, otherwise false.
+--
+-- NOTES:
+-- A socket file left behind by a program that has gone away is removed first. The event loop says when the other
+-- program connects.
+----------------------------------------------------------------------------------------------------------------------*/
+bool UnixSocketTransport::listenOn(const QByteArray& path)
+{
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	memcpy(address.sun_path, path.constData(), path.size());
+
+	::unlink(path.constData());
+	mListenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (mListenFd < 0 || ::bind(mListenFd, (struct sockaddr*)&address, sizeof(address)) != 0
+		|| ::listen(mListenFd, 1) != 0)
+	{
+		setError("listen " + QString::fromLocal8Bit(path));
+		Close();
+		return false;
+	}
+	mPath = path;
+
+	mAcceptNotifier = new QSocketNotifier(mListenFd, QSocketNotifier::Read, this);
+	connect(mAcceptNotifier, &QSocketNotifier::activated, this, [this] { acceptPeer(); });
+	qDebug() << "waiting for a connection on" << path;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: acceptPeer
+--
+-- DATE:			Oct 16, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		Benny Wang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		void acceptPeer (void)
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+-- Called from the event loop when the other program connects. Only one connection is taken. The event loop stops
+-- watching for more, but the socket stays in the file system until the transport is closed.
+----------------------------------------------------------------------------------------------------------------------*/
+void UnixSocketTransport::acceptPeer()
+{
+	int fd = ::accept4(mListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (fd < 0)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		{
+			setError("accept");
+		}
+		return;
+	}
+
+	mAcceptNotifier->setEnabled(false);
+	mFd = fd;
+	attach();
+}
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+
+#include <QSocketNotifier>
+
+#include "TermiosTransport.h"
+
+#define UNIX_SOCKET_PREFIX	"unix:"
+
+class UnixSocketTransport : public TermiosTransport
+{
+public:
+	UnixSocketTransport(QObject* parent = nullptr);
+	~UnixSocketTransport();
+
+	bool Open(const QString& name) override;
+	void Close() override;
+	qint64 Read(char* data, const qint64 maxLength) override;
+
+protected:
+	ssize_t writeSome(const char* data, const size_t length) override;
+
+private:
+	int mListenFd;
+	QSocketNotifier* mAcceptNotifier;
+	QByteArray mPath;
+
+	bool listenOn(const QByteArray& path);
+	void acceptPeer();
+};
+
+#endif